@@ -0,0 +1,669 @@
+#include "gomoku_ai.h"
+#include "gomoku_search.h"
+#include "gomoku_threats.h"
+#include "gomoku_tt.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string.h>
+
+// 搜索引擎：负极大值 alpha-beta + 主变例搜索（PVS）+ 迭代加深。
+// 搜索在局面副本上用 board_do_move/board_undo_move 走子，每手只做增量更新，不复制棋盘。
+// 每个节点先查双方的成五点（只需核对增量维护的威胁位）：己方能成五直接取胜，
+// 对方能成五则只能去堵，这类应手不消耗深度（冲四延伸）。其余情况下按双方在候选空位上的
+// 棋形给着法打分，每次挑出分数最高的一手展开，内部节点最多展开 AI_NODE_WIDTH 手。叶节点取增量评估值。
+// 着法排序分档：置换表着法，己方威胁位（落子成活四/双四），对方威胁位（堵），其余按棋形分；
+// 杀手着法与历史分只在选出的几手之间微调先后。排在后面的平稳着法（不成也不挡三以上的棋形）
+// 先少搜一层（LMR），结果超过 alpha 再按原深度重搜。
+// 内部节点的结果存入全局置换表（gomoku_tt.h），表中的着法在下次搜到同一局面时最先展开；
+// 置换表在各次搜索、各个句柄之间共享，跨步的搜索也能复用上一步的结果。
+// 多线程为 Lazy SMP：辅助线程各持一份局面副本，从错开的深度起步独立地迭代加深同一个根节点，
+// 线程之间只通过置换表共享结果；主线程负责计时、汇报进度并给出结果，结束时通知辅助线程停止。
+// 停止、预算与进度都经由控制块（gomoku_search.h），同步接口与异步接口（gomoku_search.cpp）共用这里的搜索。
+// 威胁空间搜索（gomoku_threats.h）用在两处：根节点先在预算内找 VCF/VCT 必胜序列，
+// 找到就直接走；搜索的叶节点再用很小的节点预算找 VCF，看到全宽搜索看不到的连续冲四胜。
+
+#define AI_MAX_PLY 64
+#define AI_ROOT_WIDTH 24
+#define AI_NODE_WIDTH 12
+#define AI_WIN (2 * GOMOKU_WIN_SCORE)
+#define AI_INF (AI_WIN + 1)
+#define AI_CHECK_NODES 1023
+// 胜负分的下界：绝对值不低于它的分数表示“若干步后胜/负”，存入置换表时换算成相对当前节点的步数。
+// 叶节点的 VCF 还会在搜索深度之外再加上一段必胜序列
+#define AI_WIN_BOUND (AI_WIN - 2 * AI_MAX_PLY - THREAT_MAX_PLY)
+// 根节点 VCF/VCT 的节点预算，按时间搜索时另外最多用去思考时间的 1/8；叶节点 VCF 的节点预算
+#define AI_ROOT_VCF_NODES 20000
+#define AI_ROOT_VCT_NODES 30000
+#define AI_LEAF_VCF_NODES 32
+// 排序分的档次，同一档内再按棋形分排序；棋形分远低于 AI_ORDER_DEFEND
+#define AI_ORDER_HASH (1 << 30)
+#define AI_ORDER_ATTACK (1 << 29)
+#define AI_ORDER_DEFEND (1 << 28)
+// 杀手着法的加分与历史分的缩放：只够在棋形分相近的着法之间调整先后。
+// 实测让它们压过棋形分（杀手着法单独成档）时，同深度的节点数反而多出三到五成
+#define AI_KILLER_BONUS 30
+#define AI_HISTORY_SHIFT 8
+#define AI_HISTORY_MAX (1 << 16)
+// 剩余深度不低于 AI_LMR_DEPTH 时，第 AI_LMR_INDEX 手起的平稳着法少搜一层
+#define AI_LMR_DEPTH 3
+#define AI_LMR_INDEX 3
+
+struct AiContext {
+    GomokuGame* game;
+    TranspositionTable* table;  // 分配失败时为 NULL，不用置换表
+    SearchControl* control;     // 所有线程共享：停止标志、预算、节点合计
+    GomokuSearchProgress* report;  // 只有主线程非 NULL：最近一次完成的迭代，定时汇报时发出
+    bool stopped;
+    uint64_t nodes;
+    uint64_t flushed;           // 已累加到 control->nodes 的部分
+    uint64_t ttProbes, ttHits, ttStores, ttCollisions;
+    // 着法排序：每层两个杀手着法（引起截断的着法），按走棋方与位置累计的历史分
+    int killers[AI_MAX_PLY + 1][2];
+    int history[2][GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE];
+    // 排序统计：截断次数、第一手就截断的次数、截断着法序号之和；LMR 削减与重搜次数
+    uint64_t cutoffs, firstCutoffs, cutoffIndexSum;
+    uint64_t reductions, reSearches;
+};
+
+// 走棋方 p 视角的静态评估；长连等不计胜负的五连也会让评估值很大，截断后仍低于胜负分
+static inline int ai_evaluate(const GomokuGame* g, int p) {
+    int score = board_evaluate(g, p);
+    if (score > GOMOKU_WIN_SCORE) return GOMOKU_WIN_SCORE;
+    if (score < -GOMOKU_WIN_SCORE) return -GOMOKU_WIN_SCORE;
+    return score;
+}
+
+// 置换表的键：局面哈希再区分走棋方、规则、棋盘尺寸与评估方式
+static inline uint64_t ai_key(const GomokuGame* g, int p) {
+    return g->hash ^ (p ? 0x9E3779B97F4A7C15ull : 0) ^ ((uint64_t)g->rule << 56) ^ ((uint64_t)g->size << 48)
+        ^ (g->nnue ? 0x2545F4914F6CDD1Dull : 0);
+}
+
+// 胜负分在表中按“距该节点的步数”保存，取出时再加上当前节点的步数
+static inline int ai_score_to_tt(int score, int ply) {
+    return score >= AI_WIN_BOUND ? score + ply : (score <= -AI_WIN_BOUND ? score - ply : score);
+}
+
+static inline int ai_score_from_tt(int score, int ply) {
+    return score >= AI_WIN_BOUND ? score - ply : (score <= -AI_WIN_BOUND ? score + ply : score);
+}
+
+// 把表中的着法排到最前
+static inline void ai_promote_move(AiMove* moves, int n, int code) {
+    if (code == TT_NO_MOVE) return;
+    for (int i = 0; i < n; i++) {
+        if (ai_move_code(moves[i]) == code) {
+            moves[i].score = AI_ORDER_HASH;
+            return;
+        }
+    }
+}
+
+static inline bool ai_threat_point(const GomokuGame* g, int p, int r, int c) {
+    return ((g->threatRows[p][0][r] | g->threatRows[p][1][r] | g->threatRows[p][2][r] | g->threatRows[p][3][r]) >> c) & 1u;
+}
+
+// 给 ai_generate 打过分的着法排序，返回要展开的手数：置换表着法与双方威胁位先分档，
+// 按分数选出前 width 手；杀手着法与历史分只调整这几手之间的先后，不把棋形差的着法挤进来
+static int ai_order_moves(const AiContext* s, int p, int ply, AiMove* moves, int n, int width, int hashMove) {
+    const GomokuGame* g = s->game;
+    for (int i = 0; i < n; i++) {
+        AiMove& m = moves[i];
+        if (ai_move_code(m) == hashMove) m.score = AI_ORDER_HASH;
+        else if (ai_threat_point(g, p, m.row, m.col)) m.score += AI_ORDER_ATTACK;
+        else if (ai_threat_point(g, p ^ 1, m.row, m.col)) m.score += AI_ORDER_DEFEND;
+    }
+    if (width > n) width = n;
+    if (width < n) {
+        for (int i = 0; i < width; i++) ai_pick_move(moves, i, n);
+    }
+    for (int i = 0; i < width; i++) {
+        AiMove& m = moves[i];
+        int code = ai_move_code(m);
+        if (m.score >= AI_ORDER_DEFEND) continue;
+        if (code == s->killers[ply][0]) m.score += AI_KILLER_BONUS;
+        else if (code == s->killers[ply][1]) m.score += AI_KILLER_BONUS / 2;
+        else m.score += s->history[p][code] >> AI_HISTORY_SHIFT;
+    }
+    return width;
+}
+
+// 着法 m 在第 i 位引起截断：计入排序统计；分档以外的着法记为杀手着法，并累加历史分
+static void ai_record_cutoff(AiContext* s, int p, int ply, int depth, const AiMove& m, int i) {
+    s->cutoffs++;
+    s->cutoffIndexSum += (uint64_t)i;
+    if (i == 0) s->firstCutoffs++;
+    int code = ai_move_code(m);
+    if (m.score < AI_ORDER_DEFEND && s->killers[ply][0] != code) {
+        s->killers[ply][1] = s->killers[ply][0];
+        s->killers[ply][0] = code;
+    }
+    int& h = s->history[p][code];
+    h += depth * depth;
+    if (h > AI_HISTORY_MAX) {
+        // 封顶时整表减半，保持各着法的相对大小
+        for (int k = 0; k < GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE; k++) {
+            s->history[0][k] >>= 1;
+            s->history[1][k] >>= 1;
+        }
+    }
+}
+
+// 平稳着法：在 (r,c) 落子既不成也不挡任何一方跳活三以上的棋形
+template <int N>
+static inline bool ai_is_quiet(const GomokuGame* g, int r, int c) {
+    for (int d = 0; d < LINE_DIRS; d++) {
+        int idx = board_line_index<N>(d, r, c);
+        uint8_t entry = pattern_lookup(g->lineBits[0][d][idx], g->lineBits[1][d][idx],
+            ~board_line_mask<N>(d, idx), board_line_pos(d, r, c));
+        if (pattern_shape(entry, 0) >= SHAPE_SPLIT_THREE || pattern_shape(entry, 1) >= SHAPE_SPLIT_THREE) return false;
+    }
+    return true;
+}
+
+// 把本地还没累加的节点数加到控制块，返回是否应当停止
+static inline bool ai_flush_nodes(AiContext* s) {
+    bool stop = search_add_nodes(s->control, s->nodes - s->flushed);
+    s->flushed = s->nodes;
+    return stop;
+}
+
+// 每 AI_CHECK_NODES + 1 个节点把节点数累加到控制块并检查预算；主线程还检查时间、按间隔汇报进度
+static inline bool ai_out_of_time(AiContext* s) {
+    if ((++s->nodes & AI_CHECK_NODES) == 0) {
+        SearchControl* c = s->control;
+        bool stop = ai_flush_nodes(s);
+        if (!stop && s->report) {
+            stop = search_check_time(c);
+            if (!stop && search_report_due(c)) search_publish(c, s->report);
+        }
+        s->stopped = stop;
+    }
+    return s->stopped;
+}
+
+// 叶节点：走棋方 p 在很小的预算内能否连续冲四取胜，返回必胜序列的手数，0 表示没找到。
+// 只在 p 至少有两条可冲四的五连线时才找：否则多半连一次冲四都接不上，白白耗掉叶节点的时间
+template <int N, class Rule>
+static int ai_leaf_vcf(AiContext* s, int p) {
+    if (s->game->fourLines[p] < 2) return 0;
+    ThreatContext t;
+    t.game = s->game;
+    t.attacker = p;
+    t.vct = false;
+    t.nodes = 0;
+    t.maxNodes = AI_LEAF_VCF_NODES;
+    t.timed = false;
+    t.cancel = NULL;
+    t.stopped = false;
+    t.cache = NULL;
+    int found = threat_solve<N, Rule>(&t, THREAT_VCF_DEPTH);
+    s->nodes += t.nodes;
+    return found > 0 ? t.pvLength[0] : 0;
+}
+
+template <int N, class Rule>
+static int ai_search(AiContext* s, int depth, int alpha, int beta, int ply) {
+    if (ai_out_of_time(s)) return 0;
+    GomokuGame* g = s->game;
+    int p = board_player_index(g->currentPlayer);
+    AiMove moves[AI_MAX_MOVES];
+    if (ai_five_points<N, Rule>(g, p, moves, 1)) return AI_WIN - ply - 1;
+    int n = ai_five_points<N, Rule>(g, p ^ 1, moves, AI_MAX_MOVES);
+    bool forced = n > 0;
+    int width = n;
+    if (forced) {
+        n = width = ai_remove_forbidden<N, Rule>(g, p, moves, n);
+        if (n == 0) return -(AI_WIN - ply - 2);
+        if (ply >= AI_MAX_PLY) return ai_evaluate(g, p);
+    }
+    else if (depth <= 0 || ply >= AI_MAX_PLY) {
+        int length = ai_leaf_vcf<N, Rule>(s, p);
+        if (length) return AI_WIN - ply - length;
+        return ai_evaluate(g, p);
+    }
+
+    uint64_t key = ai_key(g, p);
+    int hashMove = TT_NO_MOVE;
+    if (s->table) {
+        TtData e;
+        s->ttProbes++;
+        if (tt_probe(s->table, key, &e)) {
+            s->ttHits++;
+            hashMove = e.move;
+            int score = ai_score_from_tt(e.score, ply);
+            if (e.depth >= depth && (e.bound == TT_BOUND_EXACT
+                || (e.bound == TT_BOUND_LOWER && score >= beta)
+                || (e.bound == TT_BOUND_UPPER && score <= alpha))) {
+                return score;
+            }
+        }
+    }
+
+    if (!forced) {
+        n = ai_generate<N, Rule>(g, p, moves);
+        if (n == 0) return 0;
+        n = width = ai_order_moves(s, p, ply, moves, n, AI_NODE_WIDTH, hashMove);
+    }
+    else {
+        ai_promote_move(moves, n, hashMove);
+    }
+    int childDepth = forced ? depth : depth - 1;
+    int alphaOrig = alpha;
+    int best = -AI_INF, bestMove = TT_NO_MOVE;
+    for (int i = 0; i < width; i++) {
+        ai_pick_move(moves, i, n);
+        int reduction = !forced && depth >= AI_LMR_DEPTH && i >= AI_LMR_INDEX && moves[i].score < AI_ORDER_DEFEND
+            && ai_is_quiet<N>(g, moves[i].row, moves[i].col) ? 1 : 0;
+        ai_play<N, Rule>(g, moves[i]);
+        int score;
+        if (i == 0) {
+            score = -ai_search<N, Rule>(s, childDepth, -beta, -alpha, ply + 1);
+        }
+        else {
+            score = -ai_search<N, Rule>(s, childDepth - reduction, -alpha - 1, -alpha, ply + 1);
+            if (reduction) {
+                s->reductions++;
+                if (score > alpha && !s->stopped) {
+                    s->reSearches++;
+                    score = -ai_search<N, Rule>(s, childDepth, -alpha - 1, -alpha, ply + 1);
+                }
+            }
+            if (score > alpha && score < beta) score = -ai_search<N, Rule>(s, childDepth, -beta, -alpha, ply + 1);
+        }
+        board_undo_move<N>(g);
+        if (s->stopped) return 0;
+        if (score > best) {
+            best = score;
+            bestMove = ai_move_code(moves[i]);
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    if (!forced) ai_record_cutoff(s, p, ply, depth, moves[i], i);
+                    break;
+                }
+            }
+        }
+    }
+    if (s->table) {
+        int bound = best >= beta ? TT_BOUND_LOWER : (best > alphaOrig ? TT_BOUND_EXACT : TT_BOUND_UPPER);
+        s->ttStores++;
+        s->ttCollisions += tt_store(s->table, key, depth, bound, ai_score_to_tt(best, ply), bestMove);
+    }
+    return best;
+}
+
+// 全局置换表，第一次搜索时按默认大小分配；互斥锁只保护分配与调整大小，搜索中的读写不加锁
+static TranspositionTable table_internal;
+static std::mutex tableMutex_internal;
+
+// 调用线程的私有置换表（见 gomoku_ai_set_thread_hash_size()），没有分配时用全局表；线程结束时随对象释放
+struct ThreadTable {
+    TranspositionTable table;
+    ~ThreadTable() { tt_free(&table); }
+};
+
+static thread_local ThreadTable threadTable_internal;
+
+static TranspositionTable* ai_table(void) {
+    if (threadTable_internal.table.buckets) return &threadTable_internal.table;
+    std::lock_guard<std::mutex> lock(tableMutex_internal);
+    if (!table_internal.buckets) tt_resize(&table_internal, GOMOKU_AI_DEFAULT_HASH_MB);
+    return table_internal.buckets ? &table_internal : NULL;
+}
+
+bool gomoku_ai_set_hash_size(int megabytes) {
+    if (megabytes < 1) return false;
+    std::lock_guard<std::mutex> lock(tableMutex_internal);
+    return tt_resize(&table_internal, (size_t)megabytes);
+}
+
+bool gomoku_ai_set_thread_hash_size(int megabytes) {
+    if (megabytes < 0) return false;
+    if (megabytes == 0) {
+        tt_free(&threadTable_internal.table);
+        return true;
+    }
+    return tt_resize(&threadTable_internal.table, (size_t)megabytes);
+}
+
+void gomoku_ai_clear_hash(void) {
+    if (threadTable_internal.table.buckets) {
+        tt_clear(&threadTable_internal.table);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(tableMutex_internal);
+    tt_clear(&table_internal);
+}
+
+void gomoku_ai_hash_stats(GomokuHashStats* stats) {
+    std::lock_guard<std::mutex> lock(tableMutex_internal);
+    const TranspositionTable* tt = threadTable_internal.table.buckets ? &threadTable_internal.table : &table_internal;
+    stats->bytes = tt->bytes;
+    stats->entries = tt->buckets ? (tt->bucketMask + 1) * TT_BUCKET_ENTRIES : 0;
+    stats->hugePages = tt->hugePages;
+    stats->probes = tt->probes;
+    stats->hits = tt->hits;
+    stats->stores = tt->stores;
+    stats->collisions = tt->collisions;
+    stats->fillPermille = tt_fill_permille(tt);
+}
+
+
+static std::atomic<int> threads_internal(1);
+
+int gomoku_ai_set_threads(int threads) {
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+    if (threads > GOMOKU_AI_MAX_THREADS) threads = GOMOKU_AI_MAX_THREADS;
+    threads_internal = threads;
+    return threads;
+}
+
+int gomoku_ai_threads(void) {
+    return threads_internal;
+}
+
+
+// 从最佳着法起沿置换表中的着法走出主变例，写入 progress，走完全部撤销
+template <int N, class Rule>
+static void ai_extract_pv(AiContext* s, const AiMove& best, GomokuSearchProgress* progress) {
+    GomokuGame* g = s->game;
+    AiMove m = best;
+    int n = 0;
+    while (n < GOMOKU_SEARCH_MAX_PV) {
+        progress->pv[n][0] = m.row;
+        progress->pv[n][1] = m.col;
+        n++;
+        bool wins = ai_makes_five<N, Rule>(g, board_player_index(g->currentPlayer), m.row, m.col);
+        ai_play<N, Rule>(g, m);
+        TtData e;
+        if (wins || !s->table || !tt_probe(s->table, ai_key(g, board_player_index(g->currentPlayer)), &e)) break;
+        if (e.move == TT_NO_MOVE || e.move / GOMOKU_MAX_SIZE >= N || e.move % GOMOKU_MAX_SIZE >= N) break;
+        m.row = (unsigned char)(e.move / GOMOKU_MAX_SIZE);
+        m.col = (unsigned char)(e.move % GOMOKU_MAX_SIZE);
+        if (board_has_stone(g, 0, m.row, m.col) || board_has_stone(g, 1, m.row, m.col)) break;
+    }
+    for (int i = 0; i < n; i++) board_undo_move<N>(g);
+    progress->pvLength = n;
+}
+
+// 一个线程的根节点迭代结果
+struct AiRootResult {
+    AiMove best;
+    int score;
+    int depth;  // 完整搜完的深度
+};
+
+// 根节点迭代加深：每次迭代后把最佳着法移到最前，下一次迭代先搜它。
+// 主线程还负责在每次迭代完成后汇报进度，并在算出胜负或时间过半（下一轮多半搜不完）时结束
+template <int N, class Rule>
+static void ai_iterate(AiContext* s, AiMove* moves, int n, int firstDepth, int maxDepth, AiRootResult* r) {
+    GomokuGame* g = s->game;
+    int p = board_player_index(g->currentPlayer);
+    for (int depth = firstDepth; depth <= maxDepth; depth++) {
+        int alpha = -AI_INF, bestIndex = -1;
+        for (int i = 0; i < n; i++) {
+            ai_play<N, Rule>(g, moves[i]);
+            int score;
+            if (i == 0) {
+                score = -ai_search<N, Rule>(s, depth - 1, -AI_INF, AI_INF, 1);
+            }
+            else {
+                score = -ai_search<N, Rule>(s, depth - 1, -alpha - 1, -alpha, 1);
+                if (score > alpha && !s->stopped) score = -ai_search<N, Rule>(s, depth - 1, -AI_INF, -alpha, 1);
+            }
+            board_undo_move<N>(g);
+            if (s->stopped) break;
+            if (score > alpha) {
+                alpha = score;
+                bestIndex = i;
+            }
+        }
+        // 超时：上一轮的最佳着法总是第一个搜，只要本轮已搜完它，本轮找到的最佳着法就是可信的
+        if (bestIndex < 0) break;
+        AiMove best = moves[bestIndex];
+        memmove(moves + 1, moves, bestIndex * sizeof(AiMove));
+        moves[0] = best;
+        r->best = best;
+        r->score = alpha;
+        if (s->stopped) break;
+        r->depth = depth;
+        if (s->table) tt_store(s->table, ai_key(g, p), depth, TT_BOUND_EXACT, alpha, ai_move_code(best));
+        if (s->report) {
+            s->report->depth = depth;
+            s->report->score = alpha;
+            s->report->row = best.row;
+            s->report->col = best.col;
+            ai_extract_pv<N, Rule>(s, best, s->report);
+            ai_flush_nodes(s);
+            search_publish(s->control, s->report);
+        }
+        if (alpha >= AI_WIN_BOUND || alpha <= -AI_WIN_BOUND) break;
+        SearchControl* c = s->control;
+        if (s->report && c->timed && SearchClock::now() - c->start > (c->deadline - c->start) / 2) break;
+    }
+}
+
+// 辅助线程：奇数号线程比主线程深一层起步，让各线程尽量不在同一深度上重复工作
+template <int N, class Rule>
+static void ai_helper(AiContext* s, const AiMove* rootMoves, int n, int index, int maxDepth) {
+    AiMove moves[AI_MAX_MOVES];
+    memcpy(moves, rootMoves, n * sizeof(AiMove));
+    AiRootResult r = {};
+    ai_iterate<N, Rule>(s, moves, n, 1 + (index & 1), maxDepth, &r);
+}
+
+static bool ai_init_context(AiContext* s, const GomokuGame* src, SearchControl* control, TranspositionTable* table) {
+    s->game = gomoku_game_create_variant(src->size, src->rule);
+    if (!s->game) return false;
+    memcpy(s->game, src, sizeof(GomokuGame));
+    s->table = table;
+    s->control = control;
+    for (int i = 0; i <= AI_MAX_PLY; i++) s->killers[i][0] = s->killers[i][1] = TT_NO_MOVE;
+    return true;
+}
+
+// 把线程本地的节点数与置换表计数加到合计，并释放局面副本
+static void ai_release_context(AiContext* s) {
+    ai_flush_nodes(s);
+    if (s->table) {
+        s->table->probes += s->ttProbes;
+        s->table->hits += s->ttHits;
+        s->table->stores += s->ttStores;
+        s->table->collisions += s->ttCollisions;
+    }
+    gomoku_game_destroy(s->game);
+}
+
+// 根节点：先找 VCF，再找 VCT。找到时把必胜序列的第一手写入 *move 并返回序列手数，否则返回 0。
+// 与时间一样，有节点预算时最多用去其中的 1/8
+template <int N, class Rule>
+static int ai_root_threats(AiContext* s, int p, AiMove* move) {
+    std::vector<uint64_t> cache(THREAT_CACHE_SIZE);
+    SearchControl* c = s->control;
+    ThreatContext t;
+    t.game = s->game;
+    t.attacker = p;
+    t.nodes = 0;
+    t.timed = c->timed;
+    t.deadline = c->start + (c->deadline - c->start) / 8;
+    t.cancel = &c->stop;
+    t.cache = cache.data();
+    int found = 0;
+    for (int vct = 0; vct < 2 && found <= 0; vct++) {
+        // 两种模式的失败缓存含义不同，换模式时清空
+        if (vct) memset(t.cache, 0, THREAT_CACHE_SIZE * sizeof(uint64_t));
+        t.vct = vct != 0;
+        uint64_t budget = vct ? AI_ROOT_VCT_NODES : AI_ROOT_VCF_NODES;
+        if (c->maxNodes && budget > c->maxNodes / 8) budget = c->maxNodes / 8 + 1;
+        t.maxNodes = t.nodes + budget;
+        t.stopped = false;
+        found = threat_solve<N, Rule>(&t, vct ? THREAT_VCT_DEPTH : THREAT_VCF_DEPTH);
+    }
+    s->nodes += t.nodes;
+    ai_flush_nodes(s);
+    if (found <= 0) return 0;
+    move->score = 0;
+    move->row = (unsigned char)(t.pv[0][0] / GOMOKU_MAX_SIZE);
+    move->col = (unsigned char)(t.pv[0][0] % GOMOKU_MAX_SIZE);
+    return t.pvLength[0];
+}
+
+template <int N, class Rule>
+static bool ai_run_internal(const GomokuGame* src, int maxDepth, SearchControl* control, int* row, int* col, GomokuAiStats* stats) {
+    AiContext s = {};
+    if (maxDepth <= 0 || maxDepth > GOMOKU_AI_MAX_DEPTH) maxDepth = GOMOKU_AI_MAX_DEPTH;
+    TranspositionTable* table = ai_table();
+    if (table) table->generation++;
+    if (!ai_init_context(&s, src, control, table)) return false;
+    GomokuGame* g = s.game;
+    int p = board_player_index(g->currentPlayer);
+    GomokuSearchProgress report = {};
+    report.row = report.col = -1;
+    s.report = &report;
+
+    AiMove moves[AI_MAX_MOVES];
+    int n;
+    AiRootResult result = {};
+    if (ai_five_points<N, Rule>(g, p, moves, 1)) {
+        n = 1;
+        result.score = AI_WIN - 1;
+    }
+    else {
+        // 对方有成五点时只在堵点中选；黑方堵不住（堵点都是禁手）时已经输了，随便下一手合法的棋
+        n = ai_five_points<N, Rule>(g, p ^ 1, moves, AI_MAX_MOVES);
+        if (n > 0) n = ai_remove_forbidden<N, Rule>(g, p, moves, n);
+        if (n == 0) n = ai_generate<N, Rule>(g, p, moves);
+        TtData e;
+        n = ai_order_moves(&s, p, 0, moves, n, AI_ROOT_WIDTH, table && tt_probe(table, ai_key(g, p), &e) ? e.move : TT_NO_MOVE);
+        for (int i = 0; i < n; i++) ai_pick_move(moves, i, n);
+        int length = n > 1 ? ai_root_threats<N, Rule>(&s, p, &moves[0]) : 0;
+        if (length) {
+            n = 1;
+            result.score = AI_WIN - length;
+        }
+    }
+    if (n > 0) result.best = moves[0];
+
+    // 主线程搜索时会重排 moves，辅助线程从一份固定的副本开始
+    int threads = n > 1 ? gomoku_ai_threads() : 1;
+    std::vector<AiMove> rootMoves(moves, moves + n);
+    std::vector<AiContext> helpers(threads - 1);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads - 1; i++) {
+        if (!ai_init_context(&helpers[i], src, control, table)) break;
+        workers.emplace_back(ai_helper<N, Rule>, &helpers[i], rootMoves.data(), n, i + 1, maxDepth);
+    }
+    if (n > 1) ai_iterate<N, Rule>(&s, moves, n, 1, maxDepth, &result);
+    control->stop = true;
+    uint64_t nodes = s.nodes;
+    uint64_t cutoffs = s.cutoffs, firstCutoffs = s.firstCutoffs, cutoffIndexSum = s.cutoffIndexSum;
+    uint64_t reductions = s.reductions, reSearches = s.reSearches;
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+        nodes += helpers[i].nodes;
+        cutoffs += helpers[i].cutoffs;
+        firstCutoffs += helpers[i].firstCutoffs;
+        cutoffIndexSum += helpers[i].cutoffIndexSum;
+        reductions += helpers[i].reductions;
+        reSearches += helpers[i].reSearches;
+        ai_release_context(&helpers[i]);
+    }
+
+    // 最终结果：停在迭代中途时最佳着法可能比最近一次汇报的新，主变例只剩这一手
+    if (n > 0) {
+        *row = result.best.row;
+        *col = result.best.col;
+        if (report.row != result.best.row || report.col != result.best.col || report.pvLength == 0) {
+            report.row = result.best.row;
+            report.col = result.best.col;
+            report.pv[0][0] = result.best.row;
+            report.pv[0][1] = result.best.col;
+            report.pvLength = 1;
+        }
+        report.depth = result.depth;
+        report.score = result.score;
+    }
+    ai_release_context(&s);
+    report.done = true;
+    search_publish(control, &report);
+    if (stats) {
+        int ms = report.timeMs;
+        stats->depth = result.depth;
+        stats->score = result.score;
+        stats->nodes = nodes;
+        stats->timeMs = ms;
+        stats->nodesPerSecond = nodes * 1000 / (uint64_t)(ms > 0 ? ms : 1);
+        stats->threads = 1 + (int)workers.size();
+        stats->cutoffs = cutoffs;
+        stats->firstMoveCutoffRate = cutoffs ? (double)firstCutoffs / cutoffs : 0.0;
+        stats->averageCutoffIndex = cutoffs ? (double)cutoffIndexSum / cutoffs : 0.0;
+        stats->reductions = reductions;
+        stats->reSearches = reSearches;
+        stats->bookMove = false;
+    }
+    return n > 0;
+}
+
+bool ai_search_run(const GomokuGame* g, int maxDepth, SearchControl* control, int* row, int* col, GomokuAiStats* stats) {
+    double score;
+    if (book_search_move(g, control, row, col, &score)) {
+        if (stats) {
+            memset(stats, 0, sizeof(*stats));
+            stats->threads = 1;
+            stats->bookMove = true;
+        }
+        return true;
+    }
+    GOMOKU_DISPATCH(g, ai_run_internal, g, maxDepth, control, row, col, stats);
+}
+
+bool gomoku_game_ai_best_move(const GomokuGame* g, int depth_or_time, int* row, int* col, GomokuAiStats* stats) {
+    GomokuSearchLimits limits = {};
+    limits.engine = GOMOKU_ENGINE_ALPHA_BETA;
+    limits.timeMs = depth_or_time < 0 ? -depth_or_time : (depth_or_time == 0 ? GOMOKU_AI_DEFAULT_TIME_MS : 0);
+    limits.maxDepth = depth_or_time > 0 ? depth_or_time : GOMOKU_AI_MAX_DEPTH;
+    SearchControl control;
+    search_control_init(&control, &limits, NULL, NULL);
+    return ai_search_run(g, limits.maxDepth, &control, row, col, stats);
+}
+
+// 线程数依次取 1、2、4、8……直到 maxThreads（最后一档就是 maxThreads），每档先清空置换表再按深度搜索
+int gomoku_game_ai_benchmark(const GomokuGame* g, int depth, int maxThreads, GomokuThreadBench* results, int capacity) {
+    int saved = gomoku_ai_threads();
+    int count = 0;
+    double baseMs = 0;
+    for (int t = 1; count < capacity; t = t * 2 > maxThreads && t < maxThreads ? maxThreads : t * 2) {
+        gomoku_ai_set_threads(t);
+        gomoku_ai_clear_hash();
+        GomokuAiStats st;
+        int r, c;
+        if (!gomoku_game_ai_best_move(g, depth, &r, &c, &st)) break;
+        double ms = st.timeMs > 0 ? st.timeMs : 1;
+        if (count == 0) baseMs = ms;
+        results[count].threads = st.threads;
+        results[count].timeMs = st.timeMs;
+        results[count].nodes = st.nodes;
+        results[count].speedup = baseMs / ms;
+        count++;
+        if (t >= maxThreads) break;
+    }
+    gomoku_ai_set_threads(saved);
+    return count;
+}
+
+
+// ----------------- 默认实例上的全局接口 -----------------
+
+static GomokuAiStats lastStats_internal;
+
+bool gomoku_ai_best_move(int depth_or_time, int* row, int* col) {
+    return gomoku_game_ai_best_move(gomoku_default_game(), depth_or_time, row, col, &lastStats_internal);
+}
+
+void gomoku_ai_last_stats(GomokuAiStats* stats) {
+    *stats = lastStats_internal;
+}
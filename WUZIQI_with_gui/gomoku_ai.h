@@ -0,0 +1,348 @@
+#pragma once
+#ifndef GOMOKU_AI_H
+#define GOMOKU_AI_H
+#include "gomoku_logic.h"
+
+/// depth_or_time 为 0 时使用的默认思考时间（毫秒）
+#define GOMOKU_AI_DEFAULT_TIME_MS 1000
+
+/// 迭代加深的最大深度
+#define GOMOKU_AI_MAX_DEPTH 32
+
+/// 置换表的默认大小（MB），第一次搜索时分配
+#define GOMOKU_AI_DEFAULT_HASH_MB 64
+
+/// 搜索线程数上限
+#define GOMOKU_AI_MAX_THREADS 256
+
+/// 蒙特卡洛树搜索结点池的默认大小（MB），第一次搜索时分配
+#define GOMOKU_MCTS_DEFAULT_MB 64
+
+/// 进度回调的默认间隔（毫秒）
+#define GOMOKU_SEARCH_DEFAULT_REPORT_MS 100
+
+/// 搜索进度中主变例最多的手数
+#define GOMOKU_SEARCH_MAX_PV 32
+
+/// 威胁空间搜索返回的必胜序列最多的手数（双方合计）
+#define GOMOKU_THREAT_MAX_MOVES 72
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/**
+	 * 一次搜索的统计信息。
+	 */
+	typedef struct GomokuAiStats {
+		int depth;                // 完整搜索完的迭代深度
+		int score;                // 最佳着法的分数，从走棋方的角度计算；绝对值接近 2 * GOMOKU_WIN_SCORE 表示已算出胜负
+		uint64_t nodes;           // 搜索的节点数（所有线程合计）
+		int timeMs;               // 用时（毫秒）
+		uint64_t nodesPerSecond;  // 每秒节点数（所有线程合计）
+		int threads;              // 参与搜索的线程数
+		uint64_t cutoffs;             // 非强制节点上的 beta 截断次数
+		double firstMoveCutoffRate;   // 截断发生在第一手的比例，越接近 1 说明着法排序越好
+		double averageCutoffIndex;    // 引起截断的着法的平均序号（从 0 开始）
+		uint64_t reductions;          // 后排平稳着法被少搜一层（LMR）的次数
+		uint64_t reSearches;          // 削减后的结果超过 alpha、按原深度重搜的次数
+		bool bookMove;                // 着法取自开局库，没有搜索（见 gomoku_ai_set_book()）
+	} GomokuAiStats;
+
+	/**
+	 * 多线程测速中一档线程数的结果，见 gomoku_game_ai_benchmark()。
+	 */
+	typedef struct GomokuThreadBench {
+		int threads;     // 线程数
+		int timeMs;      // 搜完指定深度的用时（毫秒）
+		uint64_t nodes;  // 所有线程的节点数合计
+		double speedup;  // 相对单线程的用时加速比
+	} GomokuThreadBench;
+
+	/**
+	 * 置换表统计。置换表在所有句柄、所有搜索之间共享，计数从上次分配或清空时开始累计。
+	 */
+	typedef struct GomokuHashStats {
+		uint64_t bytes;       // 实际分配的字节数（向下取 2 的幂个 64 字节的桶）
+		uint64_t entries;     // 表项数（每桶 4 个）
+		bool hugePages;       // 是否用上了大页
+		uint64_t probes;      // 查询次数
+		uint64_t hits;        // 命中次数，命中率 = hits / probes
+		uint64_t stores;      // 写入次数
+		uint64_t collisions;  // 索引冲突：写入时挤掉了同一次搜索中另一个局面的表项
+		int fillPermille;     // 最近一次搜索写入的表项占全表的千分比（抽样估计）
+	} GomokuHashStats;
+
+	/**
+	 * 威胁空间搜索的模式：VCF 只走冲四，VCT 还可以走活三（同时也会先找 VCF）。
+	 */
+	typedef enum GomokuThreatMode {
+		GOMOKU_THREAT_VCF = 0,
+		GOMOKU_THREAT_VCT
+	} GomokuThreatMode;
+
+	typedef enum GomokuThreatStatus {
+		GOMOKU_THREAT_NONE = 0,  // 在深度上限内没有必胜序列
+		GOMOKU_THREAT_WIN,       // 找到必胜序列
+		GOMOKU_THREAT_UNKNOWN    // 节点或时间预算用完，未能得出结论
+	} GomokuThreatStatus;
+
+	/**
+	 * 威胁空间搜索的结果，见 gomoku_game_threat_search()。
+	 */
+	typedef struct GomokuThreatResult {
+		GomokuThreatStatus status;
+		int length;                               // 必胜序列的手数，从走棋方开始双方交替，最后一手为走棋方成五
+		int moves[GOMOKU_THREAT_MAX_MOVES][2];    // 必胜序列的 {row, col}
+		uint64_t nodes;                           // 搜索的节点数
+		int timeMs;                               // 用时（毫秒）
+	} GomokuThreatResult;
+
+	/**
+	 * 蒙特卡洛树搜索的统计信息，见 gomoku_game_mcts_best_move()。
+	 */
+	typedef struct GomokuMctsStats {
+		uint64_t playouts;           // 本次搜索的模拟次数（所有线程合计）
+		uint64_t rootVisits;         // 根结点的累计访问次数（含复用下来的）
+		uint64_t reusedVisits;       // 搜索开始时从上一手的树继承的根结点访问次数
+		uint32_t nodes;              // 树的结点数
+		uint32_t reusedNodes;        // 从上一手的树复用的结点数
+		int timeMs;                  // 用时（毫秒）
+		uint64_t playoutsPerSecond;  // 每秒模拟次数
+		int threads;                 // 参与搜索的线程数
+		double winRate;              // 所选着法的胜率估计（和棋按半胜计）；取自开局库时为库里的得分率
+		bool bookMove;               // 着法取自开局库，没有搜索
+	} GomokuMctsStats;
+
+	typedef enum GomokuEngine {
+		GOMOKU_ENGINE_ALPHA_BETA = 0,  // alpha-beta 迭代加深，见 gomoku_game_ai_best_move()
+		GOMOKU_ENGINE_MCTS             // 蒙特卡洛树搜索，见 gomoku_game_mcts_best_move()
+	} GomokuEngine;
+
+	/**
+	 * 异步搜索的限制，见 gomoku_search_start()。各项都不限时一直搜到 gomoku_search_stop()。
+	 */
+	typedef struct GomokuSearchLimits {
+		GomokuEngine engine;
+		int timeMs;         // 墙钟时间预算（毫秒），<= 0 表示不限
+		uint64_t maxNodes;  // 节点预算（所有线程合计；MCTS 为模拟次数），0 表示不限；alpha-beta 每个线程按 1024 个节点一块结算，可能略超
+		int maxDepth;       // 最大迭代深度（只用于 alpha-beta），<= 0 表示 GOMOKU_AI_MAX_DEPTH
+		int reportMs;       // 定时进度回调的间隔（毫秒），<= 0 表示 GOMOKU_SEARCH_DEFAULT_REPORT_MS；alpha-beta 另外在每层迭代完成时回调
+	} GomokuSearchLimits;
+
+	/**
+	 * 搜索进度：到目前为止的最佳着法与主变例。
+	 */
+	typedef struct GomokuSearchProgress {
+		int depth;                               // alpha-beta 为完整搜完的迭代深度，MCTS 为主变例的手数
+		int score;                               // alpha-beta 为走棋方的分数；MCTS 为最佳着法胜率的千分数
+		int row, col;                            // 最佳着法，还没有时为 -1
+		int pvLength;                            // 主变例的手数，从最佳着法开始双方交替
+		int pv[GOMOKU_SEARCH_MAX_PV][2];         // 主变例的 {row, col}
+		uint64_t nodes;                          // 节点数（所有线程合计；MCTS 为模拟次数）
+		uint64_t nodesPerSecond;
+		int timeMs;                              // 从开始搜索起的用时（毫秒）
+		bool done;                               // 搜索已结束，这是最终结果
+	} GomokuSearchProgress;
+
+	/**
+	 * 进度回调，在搜索线程中调用，应尽快返回；不要在回调里调用同一搜索的 gomoku_search_wait()/gomoku_search_destroy()。
+	 */
+	typedef void (*GomokuProgressCallback)(const GomokuSearchProgress* progress, void* userData);
+
+	/// 异步搜索的句柄，见 gomoku_search_start()
+	typedef struct GomokuSearch GomokuSearch;
+
+	typedef enum GomokuProofResult {
+		GOMOKU_PROOF_UNKNOWN = 0,  // 节点预算内既没证明必胜也没证明必败
+		GOMOKU_PROOF_WIN,          // 走棋方必胜
+		GOMOKU_PROOF_LOSS          // 走棋方必败
+	} GomokuProofResult;
+
+	/**
+	 * 证明数搜索的结果，见 gomoku_game_prove()。
+	 */
+	typedef struct GomokuProofStats {
+		GomokuProofResult result;
+		int row, col;        // 必胜时的第一手，否则为 -1
+		uint64_t nodes;      // 展开的结点数
+		uint64_t proofSize;  // 证明树的结点数（未证明时为 0）
+		uint64_t tableBytes; // 置换表实际占用的字节数
+		int timeMs;          // 用时（毫秒）
+	} GomokuProofStats;
+
+	/**
+	 * 为当前玩家选择一手棋，写入 *row、*col，但不落子。
+	 * depth_or_time > 0 表示按该深度搜索（超过 GOMOKU_AI_MAX_DEPTH 时截断），
+	 * depth_or_time < 0 表示思考 -depth_or_time 毫秒，depth_or_time == 0 表示思考 GOMOKU_AI_DEFAULT_TIME_MS 毫秒。
+	 * 返回 false 表示无处可下（棋盘已满或只剩禁手点）。
+	 * 搜索为负极大值 alpha-beta 加主变例搜索（PVS）与迭代加深，在局面副本上用增量走子/撤销，不修改当前对局；
+	 * 按时间搜索时返回最后一次完成（或已搜完首个着法）的迭代的结果。
+	 * 有成五点时直接返回成五点，对方有成五点时只在堵点中选择。
+	 * 搜索前先在小预算内做威胁空间搜索，找到 VCF/VCT 必胜序列时直接走它的第一手。
+	 * 着法按置换表着法、己方活四/双四点、对方活四/双四点、棋形分排序，杀手着法与历史分微调先后；
+	 * 排在后面的平稳着法先少搜一层（late move reductions），排序效果见 GomokuAiStats 中的截断统计。
+	 * 设置了开局库（见 gomoku_book.h 中的 gomoku_ai_set_book()）且库里有当前局面时不搜索，直接走库里的着法。
+	 */
+	bool gomoku_ai_best_move(int depth_or_time, int* row, int* col);
+
+	/**
+	 * 获取最近一次 gomoku_ai_best_move() 的统计信息。
+	 */
+	void gomoku_ai_last_stats(GomokuAiStats* stats);
+
+	/**
+	 * 按 megabytes 重新分配置换表并清空，实际大小向下取整到 2 的幂。
+	 * 整张表一次分配，系统允许时使用大页（Windows 需要“锁定内存页”权限，Linux 需要预留的大页），否则用普通页。
+	 * 表项不加锁读写（每个表项以 键 ^ 数据 校验，写到一半的表项读出来校验不过，按未命中处理），可供多个搜索线程共享。
+	 * 返回 false 表示参数无效或分配失败，此时原表保持不变。不要在搜索进行中调用。
+	 */
+	bool gomoku_ai_set_hash_size(int megabytes);
+
+	/**
+	 * 让调用线程此后发起的搜索改用一张线程私有的置换表，大小为 megabytes（向下取整到 2 的幂）；megabytes 为 0 时释放私有表、恢复共享表。
+	 * 用于多个线程各自跑互不相干的单线程搜索（如自对弈）：搜索结果只取决于局面与这张表的内容，不受其他线程的搜索影响，
+	 * 配合按深度搜索与每局前的 gomoku_ai_clear_hash() 即可逐位复现。私有表在线程结束时自动释放。返回 false 表示分配失败。
+	 */
+	bool gomoku_ai_set_thread_hash_size(int megabytes);
+
+	/**
+	 * 清空调用线程所用的置换表（有私有表时为私有表，否则为共享表）及其统计。不要在搜索进行中调用。
+	 */
+	void gomoku_ai_clear_hash(void);
+
+	/**
+	 * 获取调用线程所用的置换表的大小、命中率、冲突与占用统计。
+	 */
+	void gomoku_ai_hash_stats(GomokuHashStats* stats);
+
+	/**
+	 * 设置搜索线程数，threads <= 0 表示使用全部逻辑核心；超过 GOMOKU_AI_MAX_THREADS 时截断。返回实际的线程数。
+	 * 多线程为 Lazy SMP：辅助线程从错开的深度起步，各自独立地迭代加深同一个根节点，只通过置换表共享结果；
+	 * 主线程负责计时并给出结果。默认为 1（单线程）。
+	 */
+	int gomoku_ai_set_threads(int threads);
+
+	/**
+	 * 获取当前的搜索线程数。
+	 */
+	int gomoku_ai_threads(void);
+
+	/**
+	 * 对指定句柄搜索，含义同 gomoku_ai_best_move()；stats 可为 NULL。
+	 * 不同句柄可以在不同线程中同时搜索。搜索期间 g 不能被修改。
+	 */
+	bool gomoku_game_ai_best_move(const GomokuGame* g, int depth_or_time, int* row, int* col, GomokuAiStats* stats);
+
+	/**
+	 * 威胁空间搜索：当前玩家能否只靠连续冲四（VCF）或冲四加活三（VCT）取胜，不修改当前对局。
+	 * 进攻方只走冲四/活三，防守方只考虑堵成五点、堵活三的线段以及自己冲四反击，
+	 * 因此能在很小的代价下看到比全宽搜索深得多的杀棋。
+	 * maxNodes 为节点预算（0 表示不限），timeMs 为时间预算（<= 0 表示不限）。
+	 * 找到时返回 true，必胜序列中防守方的应手取最先尝试的一种（其余应手同样会输）。
+	 */
+	bool gomoku_game_threat_search(const GomokuGame* g, GomokuThreatMode mode, uint64_t maxNodes, int timeMs, GomokuThreatResult* result);
+
+	/**
+	 * 对默认实例做威胁空间搜索，含义同 gomoku_game_threat_search()。
+	 */
+	bool gomoku_threat_search(GomokuThreatMode mode, uint64_t maxNodes, int timeMs, GomokuThreatResult* result);
+
+	/**
+	 * 用证明数搜索（df-pn）证明局面 g 的胜负，适合对存档局面做赛后分析，不修改 g。
+	 * 搜索空间与 gomoku_game_threat_search() 相同（进攻方走冲四、活三，防守方的应手完整），
+	 * 但按证明数/反证数总是展开最容易证明的分支，能证明深得多的杀棋。
+	 * 先证明走棋方必胜，不成立时再证明对方必胜（即走棋方必败）；两次共用 maxNodes 个结点的预算（0 表示不限）。
+	 * 置换表按 tableMb 一次分配（向下取 2 的幂，分配失败时逐次减半），满了按子树规模淘汰，内存不会增长。
+	 * 返回证明结果；stats 不能为 NULL。
+	 */
+	GomokuProofResult gomoku_game_prove(const GomokuGame* g, uint64_t maxNodes, int tableMb, GomokuProofStats* stats);
+
+	/**
+	 * 对默认实例做证明数搜索，含义同 gomoku_game_prove()。
+	 */
+	GomokuProofResult gomoku_prove(uint64_t maxNodes, int tableMb, GomokuProofStats* stats);
+
+	/**
+	 * 用蒙特卡洛树搜索（UCT）为 g 的走棋方选择一手棋，不修改 g；stats 可为 NULL。
+	 * playouts_or_time > 0 表示做这么多次模拟，< 0 表示思考 -playouts_or_time 毫秒，== 0 表示思考 GOMOKU_AI_DEFAULT_TIME_MS 毫秒。
+	 * 线程数同 gomoku_ai_threads()，各线程共享同一棵树（虚拟损失）。随机走子按冲四、活三等威胁加偏。
+	 * 搜索树在调用之间保留：g 是上次搜索的局面再走几手时，沿这几手找到的子树会原样保留下来继续用。
+	 * 同一时刻只有一个调用在用这棵树，其余调用排队等待。返回 false 表示无处可下。
+	 */
+	bool gomoku_game_mcts_best_move(const GomokuGame* g, int playouts_or_time, int* row, int* col, GomokuMctsStats* stats);
+
+	/**
+	 * 对默认实例做蒙特卡洛树搜索，含义同 gomoku_game_mcts_best_move()。
+	 */
+	bool gomoku_mcts_best_move(int playouts_or_time, int* row, int* col);
+
+	/**
+	 * 获取最近一次 gomoku_mcts_best_move() 的统计信息。
+	 */
+	void gomoku_mcts_last_stats(GomokuMctsStats* stats);
+
+	/**
+	 * 按 megabytes 重新分配蒙特卡洛树搜索的结点池并清空搜索树。结点池分成两半，保留子树时在两半之间复制压缩；
+	 * 池满后不再展开新结点，之后的模拟从叶结点直接随机走子。返回 false 表示参数无效或分配失败，此时原结点池保持不变。
+	 */
+	bool gomoku_mcts_set_memory(int megabytes);
+
+	/**
+	 * 清空蒙特卡洛树搜索保留的搜索树。
+	 */
+	void gomoku_mcts_clear(void);
+
+	/**
+	 * 在当前线程中按 limits 同步搜索 g 的走棋方的着法，结果同 gomoku_search_wait()。
+	 * 用的是调用线程的置换表（见 gomoku_ai_set_thread_hash_size()），适合每个线程各自搜索互不相干的对局。
+	 * 线程数为 1 且只用深度或节点预算时，结果只由局面与置换表的内容决定。
+	 */
+	bool gomoku_game_search(const GomokuGame* g, const GomokuSearchLimits* limits, int* row, int* col, GomokuAiStats* stats);
+
+	/**
+	 * 在后台线程中开始搜索 g 的走棋方的着法，立即返回句柄；g 在开始时被复制，之后可以随意修改或销毁。
+	 * 按 limits 的时间/节点/深度预算搜索（任一项用完即停），也可随时用 gomoku_search_stop() 取消，
+	 * 取消后仍给出到目前为止的最佳着法。callback 可为 NULL，不用回调时可用 gomoku_search_poll() 轮询进度。
+	 * 线程数同 gomoku_ai_threads()。返回 NULL 表示内存不足。
+	 */
+	GomokuSearch* gomoku_search_start(const GomokuGame* g, const GomokuSearchLimits* limits, GomokuProgressCallback callback, void* userData);
+
+	/**
+	 * 获取最近一次进度（搜索结束后为最终结果，progress->done 为 true），不阻塞。
+	 */
+	void gomoku_search_poll(GomokuSearch* search, GomokuSearchProgress* progress);
+
+	/**
+	 * 搜索是否已经结束（预算用完、搜完或已取消），不阻塞。
+	 */
+	bool gomoku_search_done(const GomokuSearch* search);
+
+	/**
+	 * 请求停止搜索，不阻塞；搜索线程会在几毫秒内结束。
+	 */
+	void gomoku_search_stop(GomokuSearch* search);
+
+	/**
+	 * 等待搜索结束，把最佳着法写入 *row、*col；返回 false 表示无处可下。
+	 * stats 可为 NULL；alpha-beta 搜索时写入完整统计，MCTS 搜索时只写入节点数（模拟次数）、用时与线程数。
+	 */
+	bool gomoku_search_wait(GomokuSearch* search, int* row, int* col, GomokuAiStats* stats);
+
+	/**
+	 * 停止搜索、等待后台线程结束并释放句柄。search 可为 NULL。
+	 */
+	void gomoku_search_destroy(GomokuSearch* search);
+
+	/**
+	 * 多线程测速：对局面 g 按深度 depth 搜索，线程数依次取 1、2、4……直到 maxThreads，
+	 * 每档搜索前清空置换表，把用时、节点数与相对单线程的加速比（time-to-depth）写入 results，最多 capacity 档。
+	 * 返回写入的档数。会清空置换表；结束后恢复原来的线程数。
+	 */
+	int gomoku_game_ai_benchmark(const GomokuGame* g, int depth, int maxThreads, GomokuThreadBench* results, int capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GOMOKU_AI_H
@@ -0,0 +1,314 @@
+#pragma once
+#ifndef GOMOKU_BOARD_H
+#define GOMOKU_BOARD_H
+#include "gomoku_logic.h"
+#include "gomoku_nnue.h"
+#include "gomoku_patterns.h"
+#include <stdint.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 棋局状态与按棋盘尺寸特化的核心操作（逻辑层内部使用）。
+// 所有数组都按 GOMOKU_MAX_SIZE 分配，行列直接用 [r][c] 下标；循环边界、线掩码、五连线表
+// 等依赖尺寸的部分都由模板参数 N 在编译期确定，公共接口用 GOMOKU_DISPATCH_SIZE 按 g->size 分派。
+
+// 线位棋盘：每个玩家在 行/列/主对角线/副对角线 四个方向上各有一组 32 位线编码。
+// 行线第 c 位表示 (r,c)，列线与两条对角线以行号 r 作为位序号；低位留出 LINE_PAD 个空位，
+// 窗口左移/右移时不会越过第 0 位（20 路棋盘最高用到第 27 位）。
+#define LINE_PAD PATTERN_WINDOW
+#define LINE_DIRS 4
+#define LINE_COUNT (2 * GOMOKU_MAX_SIZE - 1)
+
+#define GAME_ALIGN 64
+
+// 五连线：棋盘上所有长度为 5 的连续格段（15 路 572 条、19 路 1020 条、20 路 1152 条），每格最多属于 20 条
+#define WIN_LINE_COUNT(n) (2 * (n) * ((n) - 4) + 2 * ((n) - 4) * ((n) - 4))
+#define WIN_LINES_PER_CELL 20
+
+// 胜利标记：以 (row,col) 为锚点，各方向上获胜连子在线编码中的位
+struct WinState {
+    uint32_t runs[LINE_DIRS];
+    unsigned char row, col;
+};
+
+// 一手棋的差分记录：落子位置与玩家、威胁位/禁手候选位的异或差分、落子前的胜利标记，
+// 以及落子前与撤销时的轮走方。哈希、评估等由落子位置直接推出，不必保存
+struct MoveDelta {
+    uint32_t threatFlip[2][LINE_DIRS];
+    uint32_t renjuFlip[2][LINE_DIRS];
+    WinState winBefore;
+    unsigned char row, col, player;
+    char sideBefore, sideAfter;
+};
+
+// 一局棋的全部状态。落子时会读写的线位与威胁位放在最前面，
+// 只在 GUI 取标记时才访问的 int 数组放在最后；整体按 64 字节对齐。
+struct alignas(GAME_ALIGN) GomokuGame {
+    uint32_t lineBits[2][LINE_DIRS][LINE_COUNT];
+    uint64_t hash;
+    int evalScore;
+    // 启用神经网络评估时指向全局网络，否则为 NULL（累加器 nnueAcc 见结构末尾）
+    const NnueNetwork* nnue;
+    // 恰有 p 的 3 子、没有对方棋子的五连线条数：大于 0 时 p 才有冲四可走
+    int fourLines[2];
+    int size;
+    GomokuRule rule;
+    // nearRows[k][r] 第 c 位：(r,c) 与某个棋子的切比雪夫距离不超过 k+1；nearCount 为对应的棋子计数
+    uint32_t nearRows[GOMOKU_MAX_CANDIDATE_RADIUS][GOMOKU_MAX_SIZE];
+    unsigned char nearCount[GOMOKU_MAX_CANDIDATE_RADIUS][GOMOKU_MAX_SIZE][GOMOKU_MAX_SIZE];
+    unsigned char winLineStones[WIN_LINE_COUNT(GOMOKU_MAX_SIZE)][2];
+    uint32_t lineThreats[2][LINE_DIRS][LINE_COUNT];
+    uint32_t threatRows[2][LINE_DIRS][GOMOKU_MAX_SIZE];
+    uint32_t shownThreatRows[GOMOKU_MAX_SIZE];
+    // 连珠禁手候选（只在 GOMOKU_RULE_RENJU 下维护）：[0] 黑方落子后该线棋形不低于跳活三的空位，
+    // [1] 该线成五/长连或同线双四的空位；按线保存并投影到行，见 gomoku_rules.h
+    uint32_t renjuLines[2][LINE_DIRS][LINE_COUNT];
+    uint32_t renjuRows[2][LINE_DIRS][GOMOKU_MAX_SIZE];
+    int moveCount;
+    int historyCount;  // 已记录的步数，moveCount 之后的部分可以重做
+    int threatChangeCount;
+    char currentPlayer;
+    char touchedPlayer;
+    bool touchedFlag;
+    WinState win;
+    MoveDelta deltas[GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE];
+    unsigned char threatChanges[GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE][2];
+    int winMarks[GOMOKU_MAX_SIZE][GOMOKU_MAX_SIZE];
+    int threatMarks[GOMOKU_MAX_SIZE][GOMOKU_MAX_SIZE];
+    // 两个视角的网络第一层累加器，只在 nnue 非 NULL 时随落子/提子增量维护（见 gomoku_nnue.h）
+    alignas(32) NnueAccumulator nnueAcc;
+};
+
+// 按棋盘尺寸分派到 fn<15>/fn<19>/fn<20>；不支持的尺寸在建局时就被拒绝，这里按默认尺寸处理
+#define GOMOKU_DISPATCH_SIZE(g, fn, ...) \
+    switch ((g)->size) { \
+    case 19: return fn<19>(__VA_ARGS__); \
+    case 20: return fn<20>(__VA_ARGS__); \
+    default: return fn<GOMOKU_SIZE>(__VA_ARGS__); \
+    }
+
+// Zobrist 随机键，按 r * GOMOKU_MAX_SIZE + c 编号，与棋盘尺寸无关（定义在 gomoku_logic.cpp）
+struct ZobristKeys {
+    uint64_t key[2][GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE];
+};
+
+extern const ZobristKeys gomoku_zobrist_keys;
+
+// 每格所属的五连线编号，按尺寸在编译期生成
+template <int N>
+struct WinLineTable {
+    uint16_t cellLines[N * N][WIN_LINES_PER_CELL];
+    uint8_t cellLineCount[N * N];
+};
+
+template <int N>
+constexpr WinLineTable<N> board_make_win_lines() {
+    WinLineTable<N> t = {};
+    const int dirs[4][2] = { {0,1}, {1,0}, {1,1}, {1,-1} };
+    int id = 0;
+    for (int d = 0; d < 4; d++) {
+        for (int r = 0; r < N; r++) {
+            for (int c = 0; c < N; c++) {
+                int er = r + 4 * dirs[d][0], ec = c + 4 * dirs[d][1];
+                if (er < 0 || er >= N || ec < 0 || ec >= N) continue;
+                for (int k = 0; k < 5; k++) {
+                    int cell = (r + k * dirs[d][0]) * N + (c + k * dirs[d][1]);
+                    t.cellLines[cell][t.cellLineCount[cell]++] = (uint16_t)id;
+                }
+                id++;
+            }
+        }
+    }
+    return t;
+}
+
+template <int N>
+inline const WinLineTable<N>& board_win_lines() {
+    static constexpr WinLineTable<N> table = board_make_win_lines<N>();
+    return table;
+}
+
+// 按 (X 子数, O 子数) 查一条五连线对 X 方的得分：只有一方 k 个子时按 k 取分，
+// 双方都有子的线已经成不了五，记 0
+struct WinLineValues {
+    int value[6][6];
+};
+
+constexpr WinLineValues board_make_win_line_values() {
+    WinLineValues v = {};
+    const int w[6] = { 0, 1, 12, 120, 1500, GOMOKU_WIN_SCORE };
+    for (int x = 0; x <= 5; x++)
+        for (int o = 0; o <= 5; o++)
+            v.value[x][o] = (x && o) ? 0 : (o ? -w[o] : w[x]);
+    return v;
+}
+
+inline const WinLineValues& board_win_line_values() {
+    static constexpr WinLineValues values = board_make_win_line_values();
+    return values;
+}
+
+
+static inline int board_lowest_bit(uint32_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward(&i, x);
+    return (int)i;
+#else
+    return __builtin_ctz(x);
+#endif
+}
+
+static inline int board_highest_bit(uint32_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanReverse(&i, x);
+    return (int)i;
+#else
+    return 31 - __builtin_clz(x);
+#endif
+}
+
+static inline int board_popcount(uint32_t x) {
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    return (int)((((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+}
+
+static inline int board_player_index(char p) {
+    return p == 'X' ? 0 : 1;
+}
+
+static inline int board_cell_index(int r, int c) {
+    return r * GOMOKU_MAX_SIZE + c;
+}
+
+// (r,c) 在方向 d 上所属线的编号
+template <int N>
+static inline int board_line_index(int d, int r, int c) {
+    switch (d) {
+    case 0: return r;
+    case 1: return c;
+    case 2: return r - c + N - 1;
+    default: return r + c;
+    }
+}
+
+// (r,c) 在方向 d 的线内的位序号
+static inline int board_line_pos(int d, int r, int c) {
+    return (d == 0 ? c : r) + LINE_PAD;
+}
+
+// 由线编号与位序号还原格子坐标
+template <int N>
+static inline void board_line_cell(int d, int idx, int pos, int* r, int* c) {
+    int t = pos - LINE_PAD;
+    switch (d) {
+    case 0: *r = idx; *c = t; break;
+    case 1: *r = t; *c = idx; break;
+    case 2: *r = t; *c = t - idx + N - 1; break;
+    default: *r = t; *c = idx - t; break;
+    }
+}
+
+// 方向 d 第 idx 条线上棋盘内的位；两条对角线上行号范围都是 [idx-N+1, idx] 与 [0, N-1] 的交集
+template <int N>
+static inline uint32_t board_line_mask(int d, int idx) {
+    int lo = 0, hi = N - 1;
+    if (d < 2) {
+        if (idx >= N) return 0;
+    }
+    else {
+        if (idx - N + 1 > lo) lo = idx - N + 1;
+        if (idx < hi) hi = idx;
+    }
+    return ((2u << hi) - (1u << lo)) << LINE_PAD;
+}
+
+// 落子/提子时只更新经过该格的五连线计数，同时把这些线分值的变化累加到 evalScore、更新 fourLines
+template <int N>
+static inline void board_update_eval(GomokuGame* g, int p, int r, int c, int delta) {
+    const WinLineTable<N>& t = board_win_lines<N>();
+    const WinLineValues& v = board_win_line_values();
+    const uint16_t* lines = t.cellLines[r * N + c];
+    int n = t.cellLineCount[r * N + c];
+    int score = g->evalScore;
+    int fours0 = g->fourLines[0], fours1 = g->fourLines[1];
+    for (int i = 0; i < n; i++) {
+        unsigned char* cnt = g->winLineStones[lines[i]];
+        score -= v.value[cnt[0]][cnt[1]];
+        fours0 -= cnt[0] == 3 && cnt[1] == 0;
+        fours1 -= cnt[1] == 3 && cnt[0] == 0;
+        cnt[p] = (unsigned char)(cnt[p] + delta);
+        score += v.value[cnt[0]][cnt[1]];
+        fours0 += cnt[0] == 3 && cnt[1] == 0;
+        fours1 += cnt[1] == 3 && cnt[0] == 0;
+    }
+    g->evalScore = score;
+    g->fourLines[0] = fours0;
+    g->fourLines[1] = fours1;
+}
+
+// 落子时 delta = 1、提子时 delta = -1：更新各半径邻域计数，计数在 0 与非 0 之间变化时翻转邻域位
+template <int N>
+static inline void board_update_near(GomokuGame* g, int r, int c, int delta) {
+    for (int k = 0; k < GOMOKU_MAX_CANDIDATE_RADIUS; k++) {
+        int rad = k + 1;
+        int r0 = r - rad < 0 ? 0 : r - rad, r1 = r + rad >= N ? N - 1 : r + rad;
+        int c0 = c - rad < 0 ? 0 : c - rad, c1 = c + rad >= N ? N - 1 : c + rad;
+        for (int rr = r0; rr <= r1; rr++) {
+            unsigned char* cnt = g->nearCount[k][rr];
+            uint32_t flip = 0;
+            for (int cc = c0; cc <= c1; cc++) {
+                if (delta > 0 ? cnt[cc]++ == 0 : --cnt[cc] == 0) flip |= 1u << cc;
+            }
+            g->nearRows[k][rr] ^= flip;
+        }
+    }
+}
+
+template <int N>
+static inline void board_place_stone(GomokuGame* g, int p, int r, int c) {
+    g->hash ^= gomoku_zobrist_keys.key[p][board_cell_index(r, c)];
+    board_update_eval<N>(g, p, r, c, 1);
+    if (g->nnue) nnue_update(g->nnue, g->nnueAcc, p, board_cell_index(r, c), 1);
+    board_update_near<N>(g, r, c, 1);
+    for (int d = 0; d < LINE_DIRS; d++)
+        g->lineBits[p][d][board_line_index<N>(d, r, c)] |= 1u << board_line_pos(d, r, c);
+}
+
+template <int N>
+static inline void board_remove_stone(GomokuGame* g, int p, int r, int c) {
+    g->hash ^= gomoku_zobrist_keys.key[p][board_cell_index(r, c)];
+    board_update_eval<N>(g, p, r, c, -1);
+    if (g->nnue) nnue_update(g->nnue, g->nnueAcc, p, board_cell_index(r, c), -1);
+    board_update_near<N>(g, r, c, -1);
+    for (int d = 0; d < LINE_DIRS; d++)
+        g->lineBits[p][d][board_line_index<N>(d, r, c)] &= ~(1u << board_line_pos(d, r, c));
+}
+
+// 玩家 p 视角的静态评估：启用了神经网络时用网络，盘面已有五连时仍按五连线计分以保留胜负分
+static inline int board_evaluate(const GomokuGame* g, int p) {
+    int score = p == 0 ? g->evalScore : -g->evalScore;
+    if (g->nnue && score < GOMOKU_WIN_SCORE && score > -GOMOKU_WIN_SCORE) return nnue_evaluate(g->nnue, g->nnueAcc, p);
+    return score;
+}
+
+static inline bool board_has_stone(const GomokuGame* g, int p, int r, int c) {
+    return (g->lineBits[p][0][r] >> (c + LINE_PAD)) & 1u;
+}
+
+// 五连起点：x 中连续 5 位全为 1 的最低位
+static inline uint32_t board_five_starts(uint32_t x) {
+    return x & (x >> 1) & (x >> 2) & (x >> 3) & (x >> 4);
+}
+
+// 包含第 b 位的连续 1 段
+static inline uint32_t board_run_through(uint32_t x, int b) {
+    int hi = board_lowest_bit(~x & (~0u << b));
+    int lo = board_highest_bit(~x & ((1u << b) - 1));
+    return (~0u << (lo + 1)) & ((1u << hi) - 1);
+}
+
+#endif // GOMOKU_BOARD_H
@@ -0,0 +1,293 @@
+#include "gomoku_book.h"
+#include "gomoku_board.h"
+#include "gomoku_mmap.h"
+#include "gomoku_search.h"
+#include "gomoku_symmetry.h"
+#include <algorithm>
+#include <math.h>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+// 开局库。表项只记局面（走完某一手之后）的统计，不记着法：查询时对每个空位算出走完后的规范键再查表，
+// 这样着法不必在 8 个朝向之间换算，互相对称的下法自然合并到同一个表项。
+// 文件按小端直接读写结构体，表项按键升序排列，打开后不解析、不校验表项。
+
+#define BOOK_MAGIC "GMKBOOK"
+#define BOOK_VERSION 1
+
+struct BookHeader {
+    char magic[8];
+    uint32_t version;
+    uint8_t size, rule, plies, reserved;
+    uint64_t entries;
+    uint32_t minGames;
+    uint32_t games;      // 建库时计入的棋局数
+};
+
+struct BookEntry {
+    uint64_t key;
+    uint32_t games;
+    uint32_t xWins;
+    uint32_t oWins;
+    uint32_t draws;
+};
+
+static_assert(sizeof(BookHeader) == 32 && sizeof(BookEntry) == 24, "book layout");
+
+struct GomokuBook {
+    MappedFile file;
+    const BookHeader* header;
+    const BookEntry* entries;
+    uint64_t count;
+};
+
+struct BookStats {
+    uint32_t games, xWins, oWins, draws;
+};
+
+struct GomokuBookBuilder {
+    int size;
+    GomokuRule rule;
+    int plies;
+    uint64_t games;
+    std::unordered_map<uint64_t, BookStats> positions;
+    GomokuGame* scratch;
+};
+
+// ----------------- 查询 -----------------
+
+GomokuBook* gomoku_book_open(const char* filename) {
+    GomokuBook* book = new (std::nothrow) GomokuBook();
+    if (!book) return NULL;
+    if (!mapped_file_open(&book->file, filename) || book->file.size < sizeof(BookHeader)) {
+        gomoku_book_close(book);
+        return NULL;
+    }
+    const BookHeader* h = (const BookHeader*)book->file.data;
+    if (memcmp(h->magic, BOOK_MAGIC, sizeof(h->magic)) != 0 || h->version != BOOK_VERSION
+        || (book->file.size - sizeof(BookHeader)) / sizeof(BookEntry) != h->entries
+        || (book->file.size - sizeof(BookHeader)) % sizeof(BookEntry) != 0) {
+        gomoku_book_close(book);
+        return NULL;
+    }
+    book->header = h;
+    book->entries = (const BookEntry*)(book->file.data + sizeof(BookHeader));
+    book->count = h->entries;
+    return book;
+}
+
+void gomoku_book_close(GomokuBook* book) {
+    if (!book) return;
+    mapped_file_close(&book->file);
+    delete book;
+}
+
+uint64_t gomoku_book_entries(const GomokuBook* book) {
+    return book->count;
+}
+
+int gomoku_book_board_size(const GomokuBook* book) {
+    return book->header->size;
+}
+
+GomokuRule gomoku_book_rule(const GomokuBook* book) {
+    return (GomokuRule)book->header->rule;
+}
+
+int gomoku_book_plies(const GomokuBook* book) {
+    return book->header->plies;
+}
+
+static const BookEntry* book_find(const GomokuBook* book, uint64_t key) {
+    const BookEntry* end = book->entries + book->count;
+    const BookEntry* e = std::lower_bound(book->entries, end, key,
+        [](const BookEntry& a, uint64_t k) { return a.key < k; });
+    return e < end && e->key == key ? e : NULL;
+}
+
+// 得分率的 Wilson 95% 置信下界：1 局全胜约 0.21，100 局得分 60% 约 0.50
+static double book_score(uint32_t games, double points) {
+    const double z = 1.96;
+    double n = games, p = points / n;
+    double center = p + z * z / (2 * n), spread = z * sqrt(p * (1 - p) / n + z * z / (4 * n * n));
+    return (center - spread) / (1 + z * z / n);
+}
+
+int gomoku_book_probe(const GomokuBook* book, const GomokuGame* g, GomokuBookMove* moves, int capacity) {
+    int size = g->size, ply = g->moveCount;
+    if (size != book->header->size || (int)g->rule != book->header->rule || ply >= book->header->plies) return 0;
+    if (g->evalScore >= GOMOKU_WIN_SCORE || g->evalScore <= -GOMOKU_WIN_SCORE) return 0;
+    SymmetryBoard pair[2] = {};
+    for (int i = 0; i < ply; i++) symmetry_pair_toggle(pair, i & 1, g->deltas[i].row, g->deltas[i].col);
+    int p = ply & 1, n = 0;
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            if (gomoku_game_board_cell(g, r, c) != ' ' || gomoku_game_is_forbidden(g, r, c)) continue;
+            // 在位棋盘上试下这一手求子局面的键，再撤回
+            symmetry_pair_toggle(pair, p, r, c);
+            const BookEntry* e = book_find(book, symmetry_position_key(symmetry_canonical_hash(pair, size, NULL), size, g->rule));
+            symmetry_pair_toggle(pair, p, r, c);
+            if (!e || e->games == 0) continue;
+            GomokuBookMove m;
+            m.row = r;
+            m.col = c;
+            m.games = e->games;
+            m.wins = p == 0 ? e->xWins : e->oWins;
+            m.losses = p == 0 ? e->oWins : e->xWins;
+            m.draws = e->draws;
+            m.score = book_score(m.games, m.wins + 0.5 * m.draws);
+            // 插入排序，保留分数最高的 capacity 个
+            int i = n < capacity ? n++ : capacity;
+            while (i > 0 && (moves[i - 1].score < m.score
+                || (moves[i - 1].score == m.score && moves[i - 1].games < m.games))) {
+                if (i < capacity) moves[i] = moves[i - 1];
+                i--;
+            }
+            if (i < capacity) moves[i] = m;
+        }
+    }
+    return n;
+}
+
+bool gomoku_book_move(const GomokuBook* book, const GomokuGame* g, int* row, int* col) {
+    GomokuBookMove m;
+    if (gomoku_book_probe(book, g, &m, 1) == 0) return false;
+    *row = m.row;
+    *col = m.col;
+    return true;
+}
+
+// ----------------- AI 使用的开局库 -----------------
+
+static std::atomic<const GomokuBook*> aiBook_internal(NULL);
+
+void gomoku_ai_set_book(const GomokuBook* book) {
+    aiBook_internal.store(book, std::memory_order_release);
+}
+
+const GomokuBook* gomoku_ai_book(void) {
+    return aiBook_internal.load(std::memory_order_acquire);
+}
+
+bool book_search_move(const GomokuGame* g, SearchControl* control, int* row, int* col, double* score) {
+    const GomokuBook* book = gomoku_ai_book();
+    GomokuBookMove m;
+    if (!book || gomoku_book_probe(book, g, &m, 1) == 0) return false;
+    *row = m.row;
+    *col = m.col;
+    *score = (m.wins + 0.5 * m.draws) / m.games;
+    GomokuSearchProgress report = {};
+    report.row = report.pv[0][0] = m.row;
+    report.col = report.pv[0][1] = m.col;
+    report.pvLength = 1;
+    report.done = true;
+    search_publish(control, &report);
+    return true;
+}
+
+// ----------------- 建库 -----------------
+
+GomokuBookBuilder* gomoku_book_builder_create(int size, GomokuRule rule, int plies) {
+    if (plies < 1 || plies > 255) return NULL;
+    GomokuBookBuilder* b = new (std::nothrow) GomokuBookBuilder();
+    if (!b) return NULL;
+    b->scratch = gomoku_game_create_variant(size, rule);
+    if (!b->scratch) {
+        delete b;
+        return NULL;
+    }
+    b->size = size;
+    b->rule = rule;
+    b->plies = plies;
+    return b;
+}
+
+void gomoku_book_builder_destroy(GomokuBookBuilder* builder) {
+    if (!builder) return;
+    gomoku_game_destroy(builder->scratch);
+    delete builder;
+}
+
+bool gomoku_book_builder_add_game(GomokuBookBuilder* builder, const GomokuGame* g, GomokuDbResult result) {
+    if (g->size != builder->size || g->rule != builder->rule || result == GOMOKU_DB_UNFINISHED) return false;
+    SymmetryBoard pair[2] = {};
+    int n = std::min(g->moveCount, builder->plies);
+    for (int ply = 0; ply < n; ply++) {
+        symmetry_pair_toggle(pair, ply & 1, g->deltas[ply].row, g->deltas[ply].col);
+        BookStats& st = builder->positions[symmetry_position_key(symmetry_canonical_hash(pair, g->size, NULL), g->size, g->rule)];
+        st.games++;
+        if (result == GOMOKU_DB_X_WINS) st.xWins++;
+        else if (result == GOMOKU_DB_O_WINS) st.oWins++;
+        else st.draws++;
+    }
+    builder->games++;
+    return true;
+}
+
+bool gomoku_book_builder_add_file(GomokuBookBuilder* builder, const char* filename) {
+    GomokuGame* g = builder->scratch;
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) return false;
+    char magic[4];
+    bool binary = fread(magic, 1, 4, fp) == 4 && memcmp(magic, "GMKB", 4) == 0;
+    fclose(fp);
+    if (binary) {
+        if (!gomoku_game_load_binary(g, filename)) return false;
+    }
+    else if (!gomoku_game_init_variant(g, builder->size, builder->rule) || !gomoku_game_load(g, filename)) {
+        return false;
+    }
+    int count = g->moveCount;
+    GomokuDbResult result = GOMOKU_DB_UNFINISHED;
+    if (count > 0) {
+        int r, c;
+        gomoku_game_get_move(g, count - 1, &r, &c);
+        if (gomoku_game_get_win_marks(g)[r][c]) result = (count & 1) ? GOMOKU_DB_X_WINS : GOMOKU_DB_O_WINS;
+        else if (count == g->size * g->size) result = GOMOKU_DB_DRAW;
+    }
+    return gomoku_book_builder_add_game(builder, g, result);
+}
+
+uint64_t gomoku_book_builder_games(const GomokuBookBuilder* builder) {
+    return builder->games;
+}
+
+uint64_t gomoku_book_builder_positions(const GomokuBookBuilder* builder) {
+    return builder->positions.size();
+}
+
+int64_t gomoku_book_builder_write(GomokuBookBuilder* builder, const char* filename, uint32_t minGames) {
+    std::vector<BookEntry> entries;
+    entries.reserve(builder->positions.size());
+    for (const auto& kv : builder->positions) {
+        if (kv.second.games < minGames) continue;
+        BookEntry e = { kv.first, kv.second.games, kv.second.xWins, kv.second.oWins, kv.second.draws };
+        entries.push_back(e);
+    }
+    std::sort(entries.begin(), entries.end(), [](const BookEntry& a, const BookEntry& b) { return a.key < b.key; });
+    BookHeader h = {};
+    memcpy(h.magic, BOOK_MAGIC, sizeof(h.magic));
+    h.version = BOOK_VERSION;
+    h.size = (uint8_t)builder->size;
+    h.rule = (uint8_t)builder->rule;
+    h.plies = (uint8_t)builder->plies;
+    h.entries = entries.size();
+    h.minGames = minGames;
+    h.games = (uint32_t)std::min<uint64_t>(builder->games, UINT32_MAX);
+    std::string tmp = std::string(filename) + ".tmp";
+    FILE* fp = fopen(tmp.c_str(), "wb");
+    if (!fp) return -1;
+    bool ok = fwrite(&h, sizeof(h), 1, fp) == 1
+        && fwrite(entries.data(), sizeof(BookEntry), entries.size(), fp) == entries.size()
+        && file_sync(fp);
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || !mapped_file_replace(tmp.c_str(), filename)) {
+        remove(tmp.c_str());
+        return -1;
+    }
+    return (int64_t)entries.size();
+}
@@ -0,0 +1,124 @@
+#pragma once
+#ifndef GOMOKU_BOOK_H
+#define GOMOKU_BOOK_H
+#include "gomoku_logic.h"
+#include "gomoku_db.h"
+
+/// 开局库默认收录到第几手
+#define GOMOKU_BOOK_DEFAULT_PLIES 14
+
+/// 开局库默认只收录至少经过这么多局的局面
+#define GOMOKU_BOOK_DEFAULT_MIN_GAMES 4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/**
+	 * 开局库的句柄。开局库是一个文件：32 字节文件头（尺寸、规则、收录手数、表项数）之后是
+	 * 按规范局面哈希排序的定长表项 (哈希, 局数, 'X' 胜局数, 'O' 胜局数, 和局数)。
+	 * 打开时只做内存映射并检查文件头与长度，不解析表项；每次查找是一次 O(log n) 的二分查找。
+	 * 规范局面哈希与棋谱库相同（gomoku_game_canonical_hash() 再区分尺寸与规则），互相对称的局面共用一个表项，
+	 * 因此库里只要有某个朝向的下法，任何朝向的局面都查得到。打开后只读，可供多个线程同时查询。
+	 */
+	typedef struct GomokuBook GomokuBook;
+
+	/**
+	 * 开局库的建库器，见 gomoku_book_builder_create()。
+	 */
+	typedef struct GomokuBookBuilder GomokuBookBuilder;
+
+	/**
+	 * 开局库中的一个着法：走完这一手后的局面在库里的统计，胜负从走这一手的一方看。
+	 */
+	typedef struct GomokuBookMove {
+		int row, col;
+		uint32_t games;   // 经过走完这一手的局面的棋局数
+		uint32_t wins;
+		uint32_t losses;
+		uint32_t draws;
+		double score;     // 排序用的分数：得分率（和棋按半胜）的 95% 置信下界，局数少的着法会被压低
+	} GomokuBookMove;
+
+	/**
+	 * 映射开局库文件。文件不存在、文件头或长度不符时返回 NULL。
+	 */
+	GomokuBook* gomoku_book_open(const char* filename);
+
+	/**
+	 * 关闭开局库。传入 NULL 时不做任何事；仍被 gomoku_ai_set_book() 使用的库要先取消再关闭。
+	 */
+	void gomoku_book_close(GomokuBook* book);
+
+	/**
+	 * 库中的局面数。
+	 */
+	uint64_t gomoku_book_entries(const GomokuBook* book);
+
+	/**
+	 * 开局库适用的棋盘尺寸、规则与收录的手数。
+	 */
+	int gomoku_book_board_size(const GomokuBook* book);
+	GomokuRule gomoku_book_rule(const GomokuBook* book);
+	int gomoku_book_plies(const GomokuBook* book);
+
+	/**
+	 * 列出 g 当前局面下库里有的着法，按 score 从高到低写入至多 capacity 个，返回写入的个数。
+	 * 尺寸或规则与库不符、已超出收录手数、或已分出胜负时返回 0。对每个空位查一次走完后的局面，
+	 * 各朝向的哈希随走子增量计算，整个查询不分配内存，通常在几十微秒内完成。
+	 */
+	int gomoku_book_probe(const GomokuBook* book, const GomokuGame* g, GomokuBookMove* moves, int capacity);
+
+	/**
+	 * 库里 g 当前局面下 score 最高的着法，写入 *row、*col；库里没有时返回 false。
+	 */
+	bool gomoku_book_move(const GomokuBook* book, const GomokuGame* g, int* row, int* col);
+
+	/**
+	 * 让 AI 使用开局库（NULL 表示不用）。设置后 gomoku_game_ai_best_move()、gomoku_game_mcts_best_move()
+	 * 与异步搜索在库里有着法时不再搜索，直接走 gomoku_book_move() 的着法，统计中的 bookMove 为 true。
+	 * 开局库为进程内全局一份，设置时不应有搜索在进行。
+	 */
+	void gomoku_ai_set_book(const GomokuBook* book);
+
+	/**
+	 * 当前 AI 使用的开局库，没有时为 NULL。
+	 */
+	const GomokuBook* gomoku_ai_book(void);
+
+	/**
+	 * 新建建库器：只收 size 路、rule 规则的棋局，每局收录开局后的前 plies 手（1..255）。
+	 * 参数无效或内存不足时返回 NULL。统计在内存中按局面累加，写出时才排序。
+	 */
+	GomokuBookBuilder* gomoku_book_builder_create(int size, GomokuRule rule, int plies);
+
+	void gomoku_book_builder_destroy(GomokuBookBuilder* builder);
+
+	/**
+	 * 把 g 开局到当前步的走子计入统计。尺寸或规则与建库器不符、或结果为 GOMOKU_DB_UNFINISHED 时不计入，返回 false。
+	 */
+	bool gomoku_book_builder_add_game(GomokuBookBuilder* builder, const GomokuGame* g, GomokuDbResult result);
+
+	/**
+	 * 读入一个存档文件并计入统计：gomoku_save_binary() 的二进制存档按文件记录的尺寸与规则读，
+	 * 否则按 gomoku_save() 的文本格式、以建库器的尺寸与规则重放。
+	 * 结果由最后一手判定：最后一手成五为该方胜，棋盘下满为和棋，否则视为未下完，不计入。
+	 */
+	bool gomoku_book_builder_add_file(GomokuBookBuilder* builder, const char* filename);
+
+	/**
+	 * 已计入的棋局数与不同局面数。
+	 */
+	uint64_t gomoku_book_builder_games(const GomokuBookBuilder* builder);
+	uint64_t gomoku_book_builder_positions(const GomokuBookBuilder* builder);
+
+	/**
+	 * 把经过至少 minGames 局的局面排序后写入 filename（先写临时文件，落盘后整体替换），返回写入的局面数，失败时返回 -1。
+	 */
+	int64_t gomoku_book_builder_write(GomokuBookBuilder* builder, const char* filename, uint32_t minGames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GOMOKU_BOOK_H
@@ -0,0 +1,336 @@
+#include "gomoku_db.h"
+#include "gomoku_mmap.h"
+#include "gomoku_symmetry.h"
+#include <algorithm>
+#include <new>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+// 棋谱库。写入只追加：棋谱先写进段文件，再在棋谱表末尾追加定长表项，表项是棋局存在的依据；
+// 局面索引是由棋谱推出的数据，文件头记录它覆盖了前多少局，打开时把之后的棋局重新读出放进内存。
+// 索引表项按 (键, 棋局, 手数) 排序，查询时在映射的文件上二分查找，只有命中的那一段会被换入内存。
+// 文件按小端直接读写结构体。
+
+#define DB_TABLE_MAGIC "GMKDBT1"
+#define DB_INDEX_MAGIC "GMKDBI1"
+#define DB_VERSION 1
+
+struct DbTableHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+// 棋谱表项：段号、段内偏移与长度定位棋谱
+struct DbGameEntry {
+    uint32_t offset;
+    uint16_t segment;
+    uint16_t length;
+    uint16_t plies;
+    uint8_t result, size, rule;
+    uint8_t reserved[3];
+};
+
+struct DbIndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t entries;
+    uint64_t games;      // 索引覆盖的棋局数（编号 0..games-1）
+};
+
+struct DbPosEntry {
+    uint64_t key;
+    uint32_t game;
+    uint16_t ply;
+    uint8_t result;
+    uint8_t reserved;
+};
+
+static_assert(sizeof(DbGameEntry) == 16 && sizeof(DbIndexHeader) == 32 && sizeof(DbPosEntry) == 16, "db layout");
+
+static inline bool db_entry_less(const DbPosEntry& a, const DbPosEntry& b) {
+    if (a.key != b.key) return a.key < b.key;
+    if (a.game != b.game) return a.game < b.game;
+    return a.ply < b.ply;
+}
+
+struct GomokuDb {
+    std::string path;
+    bool writable;
+    FILE* table;
+    FILE* segmentFile;         // 正在追加的段（可写句柄）或最近读过的段
+    int openSegment;           // segmentFile 对应的段号，-1 表示没有
+    uint64_t gameCount;
+    int segment;               // 新棋谱写入的段与段内位置
+    uint32_t segmentBytes;
+    MappedFile index;
+    uint64_t indexEntries;
+    uint64_t indexedGames;
+    std::vector<DbPosEntry> pending;  // 索引之后加入的棋局的局面
+    bool pendingSorted;
+    GomokuGame* scratch;       // 解码棋谱用
+    bool ready;                // 打开成功；只有这时关闭才会并入索引
+};
+
+static std::string db_segment_path(const GomokuDb* db, int segment) {
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), ".%04d", segment);
+    return db->path + suffix;
+}
+
+// 把 g 开局到当前步的每个局面（含空棋盘）加入 pending
+static void db_index_game(GomokuDb* db, const GomokuGame* g, uint32_t id, int result) {
+    int size = gomoku_game_board_size(g), rule = gomoku_game_rule(g), n = gomoku_game_move_count(g);
+    SymmetryBoard pair[2] = {};
+    for (int ply = 0; ; ply++) {
+        DbPosEntry e = { symmetry_position_key(symmetry_canonical_hash(pair, size, NULL), size, rule), id, (uint16_t)ply, (uint8_t)result, 0 };
+        db->pending.push_back(e);
+        if (ply == n) break;
+        int r, c;
+        gomoku_game_get_move(g, ply, &r, &c);
+        symmetry_pair_toggle(pair, ply & 1, r, c);
+    }
+    db->pendingSorted = false;
+}
+
+static bool db_read_entry(GomokuDb* db, uint64_t id, DbGameEntry* e) {
+    return file_seek(db->table, sizeof(DbTableHeader) + id * sizeof(DbGameEntry))
+        && fread(e, sizeof(*e), 1, db->table) == 1;
+}
+
+// 切换到段 segment；可写句柄按需新建段文件
+static bool db_use_segment(GomokuDb* db, int segment) {
+    if (db->openSegment == segment) return true;
+    if (db->segmentFile) fclose(db->segmentFile);
+    db->openSegment = -1;
+    std::string name = db_segment_path(db, segment);
+    db->segmentFile = fopen(name.c_str(), db->writable ? "r+b" : "rb");
+    if (!db->segmentFile && db->writable) db->segmentFile = fopen(name.c_str(), "w+b");
+    if (!db->segmentFile) return false;
+    db->openSegment = segment;
+    return true;
+}
+
+static bool db_read_game(GomokuDb* db, const DbGameEntry* e, GomokuGame* g) {
+    unsigned char record[GOMOKU_RECORD_MAX_BYTES];
+    if (e->length > sizeof(record) || !db_use_segment(db, e->segment)) return false;
+    if (!file_seek(db->segmentFile, e->offset)
+        || fread(record, 1, e->length, db->segmentFile) != e->length) {
+        return false;
+    }
+    return gomoku_game_decode(g, record, e->length);
+}
+
+// 映射局面索引。索引不存在或损坏时当作空索引，全部棋局在打开时重新读出，关闭时重建
+static void db_open_index(GomokuDb* db) {
+    db->indexEntries = 0;
+    db->indexedGames = 0;
+    if (!mapped_file_open(&db->index, (db->path + ".pos").c_str())) return;
+    const DbIndexHeader* h = (const DbIndexHeader*)db->index.data;
+    if (db->index.size < sizeof(DbIndexHeader) || memcmp(h->magic, DB_INDEX_MAGIC, sizeof(h->magic)) != 0
+        || h->version != DB_VERSION || db->index.size != sizeof(DbIndexHeader) + h->entries * sizeof(DbPosEntry)
+        || h->games > db->gameCount) {
+        mapped_file_close(&db->index);
+        return;
+    }
+    db->indexEntries = h->entries;
+    db->indexedGames = h->games;
+}
+
+static bool db_open_table(GomokuDb* db) {
+    std::string name = db->path + ".games";
+    uint64_t bytes = file_size(name.c_str());
+    db->table = fopen(name.c_str(), db->writable ? "r+b" : "rb");
+    DbTableHeader h;
+    if (!db->table) {
+        if (!db->writable) return false;
+        db->table = fopen(name.c_str(), "w+b");
+        if (!db->table) return false;
+        memset(&h, 0, sizeof(h));
+        memcpy(h.magic, DB_TABLE_MAGIC, sizeof(h.magic));
+        h.version = DB_VERSION;
+        if (fwrite(&h, sizeof(h), 1, db->table) != 1 || !file_sync(db->table)) return false;
+        bytes = sizeof(h);
+    }
+    else if (fread(&h, sizeof(h), 1, db->table) != 1 || memcmp(h.magic, DB_TABLE_MAGIC, sizeof(h.magic)) != 0
+        || h.version != DB_VERSION) {
+        return false;
+    }
+    // 不完整的末尾表项、或指向段文件中不存在的数据的表项，都是崩溃时没写完的，丢弃
+    db->gameCount = bytes < sizeof(h) ? 0 : (bytes - sizeof(h)) / sizeof(DbGameEntry);
+    db->segment = 0;
+    db->segmentBytes = 0;
+    while (db->gameCount > 0) {
+        DbGameEntry e;
+        if (db_read_entry(db, db->gameCount - 1, &e)
+            && file_size(db_segment_path(db, e.segment).c_str()) >= (uint64_t)e.offset + e.length) {
+            db->segment = e.segment;
+            db->segmentBytes = e.offset + e.length;
+            break;
+        }
+        db->gameCount--;
+    }
+    return true;
+}
+
+GomokuDb* gomoku_db_open(const char* path, bool writable) {
+    GomokuDb* db = new (std::nothrow) GomokuDb();
+    if (!db) return NULL;
+    db->path = path;
+    db->writable = writable;
+    db->openSegment = -1;
+    db->scratch = gomoku_game_create();
+    if (!db->scratch || !db_open_table(db)) {
+        gomoku_db_close(db);
+        return NULL;
+    }
+    db_open_index(db);
+    for (uint64_t id = db->indexedGames; id < db->gameCount; id++) {
+        DbGameEntry e;
+        if (!db_read_entry(db, id, &e) || !db_read_game(db, &e, db->scratch)) {
+            gomoku_db_close(db);
+            return NULL;
+        }
+        db_index_game(db, db->scratch, (uint32_t)id, e.result);
+    }
+    db->ready = true;
+    return db;
+}
+
+void gomoku_db_close(GomokuDb* db) {
+    if (!db) return;
+    if (db->writable && db->ready) gomoku_db_commit(db);
+    if (db->segmentFile) fclose(db->segmentFile);
+    if (db->table) fclose(db->table);
+    mapped_file_close(&db->index);
+    gomoku_game_destroy(db->scratch);
+    delete db;
+}
+
+int64_t gomoku_db_add_game(GomokuDb* db, const GomokuGame* g, GomokuDbResult result) {
+    if (!db->writable || db->gameCount >= UINT32_MAX) return -1;
+    unsigned char record[GOMOKU_RECORD_MAX_BYTES];
+    int bytes = gomoku_game_encode(g, record, sizeof(record));
+    if (db->segmentBytes + (uint32_t)bytes > GOMOKU_DB_SEGMENT_BYTES) {
+        db->segment++;
+        db->segmentBytes = 0;
+    }
+    if (!db_use_segment(db, db->segment) || !file_seek(db->segmentFile, db->segmentBytes)
+        || fwrite(record, 1, bytes, db->segmentFile) != (size_t)bytes || fflush(db->segmentFile) != 0) {
+        return -1;
+    }
+    DbGameEntry e;
+    memset(&e, 0, sizeof(e));
+    e.offset = db->segmentBytes;
+    e.segment = (uint16_t)db->segment;
+    e.length = (uint16_t)bytes;
+    e.plies = (uint16_t)gomoku_game_move_count(g);
+    e.result = (uint8_t)result;
+    e.size = (uint8_t)gomoku_game_board_size(g);
+    e.rule = (uint8_t)gomoku_game_rule(g);
+    if (!file_seek(db->table, sizeof(DbTableHeader) + db->gameCount * sizeof(DbGameEntry))
+        || fwrite(&e, sizeof(e), 1, db->table) != 1 || fflush(db->table) != 0) {
+        return -1;
+    }
+    db->segmentBytes += bytes;
+    uint32_t id = (uint32_t)db->gameCount++;
+    db_index_game(db, g, id, result);
+    return id;
+}
+
+static void db_sort_pending(GomokuDb* db) {
+    if (db->pendingSorted) return;
+    std::sort(db->pending.begin(), db->pending.end(), db_entry_less);
+    db->pendingSorted = true;
+}
+
+bool gomoku_db_commit(GomokuDb* db) {
+    if (!db->writable) return false;
+    if (db->indexedGames == db->gameCount && db->pending.empty()) return true;
+    // 新索引声明覆盖的棋局必须先落盘
+    if ((db->segmentFile && !file_sync(db->segmentFile)) || !file_sync(db->table)) return false;
+    db_sort_pending(db);
+    std::string name = db->path + ".pos", temp = name + ".tmp";
+    FILE* fp = fopen(temp.c_str(), "wb");
+    if (!fp) return false;
+    setvbuf(fp, NULL, _IOFBF, 1 << 20);
+    DbIndexHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, DB_INDEX_MAGIC, sizeof(h.magic));
+    h.version = DB_VERSION;
+    h.entries = db->indexEntries + db->pending.size();
+    h.games = db->gameCount;
+    bool ok = fwrite(&h, sizeof(h), 1, fp) == 1;
+    // 原索引与新局面都已有序，顺序归并
+    const DbPosEntry* old = db->indexEntries ? (const DbPosEntry*)(db->index.data + sizeof(DbIndexHeader)) : NULL;
+    uint64_t i = 0, j = 0, n = db->pending.size();
+    while (ok && (i < db->indexEntries || j < n)) {
+        const DbPosEntry* e = (j == n || (i < db->indexEntries && db_entry_less(old[i], db->pending[j])))
+            ? &old[i++] : &db->pending[j++];
+        ok = fwrite(e, sizeof(*e), 1, fp) == 1;
+    }
+    ok = ok && file_sync(fp);
+    if (fclose(fp) != 0) ok = false;
+    mapped_file_close(&db->index);
+    if (!ok || !mapped_file_replace(temp.c_str(), name.c_str())) {
+        remove(temp.c_str());
+        db_open_index(db);
+        return false;
+    }
+    db->pending.clear();
+    db->pendingSorted = true;
+    db_open_index(db);
+    return db->indexedGames == db->gameCount;
+}
+
+uint64_t gomoku_db_game_count(const GomokuDb* db) {
+    return db->gameCount;
+}
+
+bool gomoku_db_load_game(GomokuDb* db, uint64_t id, GomokuGame* g, GomokuDbResult* result) {
+    DbGameEntry e;
+    if (id >= db->gameCount || !db_read_entry(db, id, &e) || !db_read_game(db, &e, g)) return false;
+    if (result) *result = (GomokuDbResult)e.result;
+    return true;
+}
+
+// 把 [begin, end) 中键为 key 的表项计入统计与命中列表
+static int db_collect(const DbPosEntry* begin, const DbPosEntry* end, uint64_t key,
+    uint64_t counts[4], GomokuDbHit* hits, int capacity, int found) {
+    DbPosEntry probe = { key, 0, 0, 0, 0 };
+    for (const DbPosEntry* e = std::lower_bound(begin, end, probe, db_entry_less); e < end && e->key == key; e++) {
+        counts[e->result & 3]++;
+        if (hits && found < capacity) {
+            hits[found].game = e->game;
+            hits[found].ply = e->ply;
+            found++;
+        }
+    }
+    return found;
+}
+
+int gomoku_db_query(GomokuDb* db, const GomokuGame* position, GomokuDbStats* stats, GomokuDbHit* hits, int capacity) {
+    uint64_t key = symmetry_position_key(gomoku_game_canonical_hash(position, NULL),
+        gomoku_game_board_size(position), gomoku_game_rule(position));
+    uint64_t counts[4] = { 0, 0, 0, 0 };
+    int found = 0;
+    if (db->indexEntries) {
+        const DbPosEntry* entries = (const DbPosEntry*)(db->index.data + sizeof(DbIndexHeader));
+        found = db_collect(entries, entries + db->indexEntries, key, counts, hits, capacity, found);
+    }
+    if (!db->pending.empty()) {
+        db_sort_pending(db);
+        found = db_collect(db->pending.data(), db->pending.data() + db->pending.size(), key, counts, hits, capacity, found);
+    }
+    if (stats) {
+        stats->unfinished = counts[GOMOKU_DB_UNFINISHED];
+        stats->xWins = counts[GOMOKU_DB_X_WINS];
+        stats->oWins = counts[GOMOKU_DB_O_WINS];
+        stats->draws = counts[GOMOKU_DB_DRAW];
+        stats->games = counts[0] + counts[1] + counts[2] + counts[3];
+    }
+    return found;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#ifndef GOMOKU_DB_H
+#define GOMOKU_DB_H
+#include "gomoku_logic.h"
+
+/// 一个段文件的最大字节数，写满后换下一个段
+#define GOMOKU_DB_SEGMENT_BYTES (256u * 1024 * 1024)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/**
+	 * 棋谱库的句柄。棋谱库由同一路径前缀下的几类文件组成：
+	 *   path.games   棋谱表：每局 16 字节（所在段、偏移、长度、步数、结果、尺寸、规则），按编号定长排列
+	 *   path.NNNN    段文件：只追加的二进制棋谱（gomoku_game_encode() 的格式，15 路每手 1 字节）
+	 *   path.pos     局面索引：按规范局面哈希排序的 (哈希, 棋局编号, 手数, 结果) 表项，查询时内存映射后二分查找
+	 * 规范局面哈希即 gomoku_game_canonical_hash() 再区分棋盘尺寸与规则，因此互相对称的局面查到的是同一组棋局。
+	 * 同一个库同一时间只能由一个可写句柄打开；句柄不能被多个线程同时使用。
+	 */
+	typedef struct GomokuDb GomokuDb;
+
+	/**
+	 * 一局棋的结果。
+	 */
+	typedef enum GomokuDbResult {
+		GOMOKU_DB_UNFINISHED = 0,  // 未下完（或结果未知）
+		GOMOKU_DB_X_WINS,
+		GOMOKU_DB_O_WINS,
+		GOMOKU_DB_DRAW
+	} GomokuDbResult;
+
+	/**
+	 * 经过某一局面的棋局的结果统计。
+	 */
+	typedef struct GomokuDbStats {
+		uint64_t games;       // 经过该局面的棋局数
+		uint64_t xWins;
+		uint64_t oWins;
+		uint64_t draws;
+		uint64_t unfinished;
+	} GomokuDbStats;
+
+	/**
+	 * 查询命中的一局：棋局编号与该局面出现在第几手之后（0 表示空棋盘）。
+	 * 命中的局面可能是查询局面的对称变换。
+	 */
+	typedef struct GomokuDbHit {
+		uint32_t game;
+		int ply;
+	} GomokuDbHit;
+
+	/**
+	 * 打开路径前缀 path 下的棋谱库；writable 为 true 时文件不存在则新建。失败时返回 NULL。
+	 * 上次打开后新加入、但还没有并入局面索引的棋局会从段文件里重新读出（不必重新加入），
+	 * 写到一半的棋谱表项会被丢弃。
+	 */
+	GomokuDb* gomoku_db_open(const char* path, bool writable);
+
+	/**
+	 * 并入尚未写入索引的局面（可写句柄）并关闭。传入 NULL 时不做任何事。
+	 */
+	void gomoku_db_close(GomokuDb* db);
+
+	/**
+	 * 把 g 的棋谱（开局到当前步）追加到库中，返回新棋局的编号；只读句柄或写入失败时返回 -1。
+	 * 棋谱立即写入段文件与棋谱表，各手的局面先记在内存里，gomoku_db_commit() 时并入局面索引；
+	 * 在此之前的查询也能查到它们。
+	 */
+	int64_t gomoku_db_add_game(GomokuDb* db, const GomokuGame* g, GomokuDbResult result);
+
+	/**
+	 * 把内存中新增的局面与原有索引归并成新的索引文件，落盘后整体替换并重新映射。
+	 * 归并是顺序读写，耗时与索引大小成正比；大量加入棋局时应攒一批再调用。
+	 */
+	bool gomoku_db_commit(GomokuDb* db);
+
+	/**
+	 * 库中的棋局总数。
+	 */
+	uint64_t gomoku_db_game_count(const GomokuDb* db);
+
+	/**
+	 * 读出编号为 id 的棋局到 g（按棋谱中的尺寸与规则重新开局并重放），结果写入 result（可为 NULL）。
+	 */
+	bool gomoku_db_load_game(GomokuDb* db, uint64_t id, GomokuGame* g, GomokuDbResult* result);
+
+	/**
+	 * 查询经过 position 当前局面（或其任一对称局面）的全部棋局：结果统计写入 stats，
+	 * 按棋局编号顺序把至多 capacity 个命中写入 hits（可为 NULL），返回写入的个数。
+	 * 只读取内存映射的索引，不读棋谱本身。
+	 */
+	int gomoku_db_query(GomokuDb* db, const GomokuGame* position, GomokuDbStats* stats, GomokuDbHit* hits, int capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GOMOKU_DB_H
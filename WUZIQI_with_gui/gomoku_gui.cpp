@@ -8,15 +8,26 @@
 #include <string.h>
 #include <windows.h>
 #include "gomoku_logic.h"  // 棋局逻辑接口
+#include "gomoku_ai.h"     // AI 搜索接口
+#include "gomoku_book.h"   // 开局库
 
-// 窗口和棋盘相关常量
-#define BOARD_SIZE 15
+// 窗口和棋盘相关常量；棋盘路数由逻辑层决定，格子大小见 cellSize()
 #define BOARD_PIXELS 640
 #define INFO_HEIGHT 80
 #define WINDOW_WIDTH 800
 #define WINDOW_HEIGHT (BOARD_PIXELS + INFO_HEIGHT)
-#define CELL_SIZE (BOARD_PIXELS / BOARD_SIZE)
-#define MAX_MOVES (BOARD_SIZE * BOARD_SIZE)
+#define MAX_MOVES (GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE)
+#define MENU_BUTTONS 8
+#define GAME_BUTTONS 6
+#define REVIEW_BUTTONS 5
+#define AI_THINK_MS 1000  // AI 每手的思考时间
+#define HINT_THINK_MS 250  // 提示时威胁空间搜索的时间预算
+#define HINT_NODES 2000000
+#define PROOF_NODES 5000000   // 回放中证明局面的结点预算
+#define PROOF_TABLE_MB 64
+#define AUTOSAVE_FILE "autosave.gmj"  // 对局中的自动存档日志
+#define AUTOSAVE_SYNC_MOVES 8         // 自动存档每 8 手落盘一次
+#define BOOK_FILE "gomoku.book"       // 开局库，由 book_builder 生成
 
 typedef enum { STATE_MENU, STATE_PLAY, STATE_REVIEW } AppState;  // 应用状态：菜单、游戏中、回放模式
 
@@ -37,24 +48,55 @@ int winFlag;
 char messageBuffer[256];
 Uint32 messageStart;
 int messageDuration;
-
-Button menuButtons[4];
-Button gameButtons[5];
+int boardSize = GOMOKU_SIZE;  // 菜单中选择的棋盘路数，开始/加载游戏时生效
+GomokuRule boardRule = GOMOKU_RULE_FREESTYLE;  // 菜单中选择的规则
+bool aiUseMcts = false;  // AI 用蒙特卡洛树搜索，否则用 alpha-beta
+bool aiPonder = true;    // 轮到玩家时 AI 在后台继续思考
+char aiPlayer = '\0';  // AI 执的棋子，'\0' 表示双人对战
+GomokuSearch* aiSearch = NULL;  // 正在后台进行的 AI 搜索；搜索的是开始时的局面副本
+GomokuSearch* ponderSearch = NULL;  // 轮到玩家时的后台思考（不限时，玩家落子或局面改变时停止）
+GomokuThreatResult hint;  // 最近一次提示找到的必胜序列
+bool hintShown = false;
+uint64_t hintHash;        // 提示对应局面的哈希，局面变化后不再显示
+SDL_Thread* hintThread = NULL;  // 正在后台做提示搜索的线程；搜索的是点提示时的局面副本 hintGame
+SDL_atomic_t hintDone;
+GomokuGame* hintGame = NULL;
+GomokuThreatResult hintResult;  // 提示线程的结果，由 pollHint() 取到 hint
+
+Button menuButtons[MENU_BUTTONS];
+Button gameButtons[GAME_BUTTONS];
 Button winButtons[3];
-Button reviewButtons[4];  // Prev, Next, Restart, Exit Review
-
-// 存储回放用的历史棋步
-int reviewMoves[MAX_MOVES][2];
+Button reviewButtons[REVIEW_BUTTONS];  // Prev, Next, Restart, Prove, Exit Review
+SDL_Thread* proofThread = NULL;  // 正在后台证明回放局面的线程；证明期间不能前进后退
+SDL_atomic_t proofDone;
+GomokuProofStats proofStats;
+GomokuBook* book = NULL;  // 启动时映射的开局库，没有时为 NULL；AI 与提示在库里有着法时直接走库里的着法
+GomokuJournal* autosave = NULL;  // 每手追加到自动存档；正常回到菜单或退出时删除，异常退出后下次启动据此恢复
 
 // 函数原型
 void startGame(void);
 void loadGame(void);
 void aiBattle(void);
+void aiMove(void);
+void cancelAiSearch(void);
+void startAutosave(void);
+void stopAutosave(void);
+void recoverAutosave(void);
+void ponder(void);
+void stopPonder(int row, int col);
+void toggleBoardSize(void);
+void toggleRule(void);
+void updateVariantLabels(void);
+void toggleEngine(void);
+void togglePonder(void);
 void exitGame(void);
 void undoMove(void);
+void redoMove(void);
+bool lastMoveWon(void);
 void saveGame(void);
 void loadGamePlay(void);
 void hintMove(void);
+void pollHint(void);
 void replayGame(void);
 void restartGame(void);
 
@@ -63,8 +105,13 @@ void setupReviewButtons(void);
 void reviewPrev(void);
 void reviewNext(void);
 void reviewRestart(void);
+void reviewProve(void);
 void reviewExit(void);
-void applyReviewSteps(void);
+
+// 每格像素数，随当前棋局的路数变化
+int cellSize(void) {
+    return BOARD_PIXELS / gomoku_board_size();
+}
 
 // 在底部信息区显示短暂消息
 void showMessage(const char* msg, int duration) {
@@ -99,18 +146,25 @@ void drawButton(const Button* btn) {
 // ----------------- 回调函数 -----------------
 // 开始新游戏：初始化棋局，切换到游戏状态
 void startGame(void) {
-    gomoku_init();
+    cancelAiSearch();
+    gomoku_init_variant(boardSize, boardRule);
+    aiPlayer = '\0';
     appState = STATE_PLAY;
     winFlag = 0;
+    startAutosave();
     SDL_Log("Started game, state PLAY");
 }
 
 // 从文件加载游戏并进入游戏
 void loadGame(void) {
+    cancelAiSearch();
+    gomoku_init_variant(boardSize, boardRule);
+    aiPlayer = '\0';
     if (gomoku_load("save.txt") != 0) {
         showMessage("Game loaded", 2);
         appState = STATE_PLAY;
         winFlag = 0;
+        startAutosave();
         SDL_Log("Loaded game, state PLAY");
     }
     else {
@@ -119,9 +173,164 @@ void loadGame(void) {
     }
 }
 
-// AI对战（未实现）
+// AI对战：玩家执黑（X）先行，AI 执白（O）
 void aiBattle(void) {
-    showMessage("AI Battle not implemented", 2);
+    cancelAiSearch();
+    gomoku_init_variant(boardSize, boardRule);
+    if (gomoku_nnue_loaded() && !gomoku_set_nnue(true)) {
+        SDL_Log("NNUE evaluator does not fit a %dx%d board, using pattern evaluation", boardSize, boardSize);
+    }
+    aiPlayer = 'O';
+    appState = STATE_PLAY;
+    winFlag = 0;
+    startAutosave();
+    showMessage("AI Battle: you play X", 2);
+    SDL_Log("Started AI battle, state PLAY");
+}
+
+// 放弃正在进行的 AI 搜索与后台思考（悔棋、读档、回到菜单前调用）
+void cancelAiSearch(void) {
+    gomoku_search_destroy(aiSearch);
+    aiSearch = NULL;
+    gomoku_search_destroy(ponderSearch);
+    ponderSearch = NULL;
+}
+
+// 为刚开始的对局新建自动存档日志（覆盖上一局的）
+void startAutosave(void) {
+    gomoku_journal_close(autosave);
+    autosave = gomoku_journal_open(AUTOSAVE_FILE, gomoku_default_game(), AUTOSAVE_SYNC_MOVES);
+    if (!autosave) SDL_Log("Autosave disabled: cannot open %s", AUTOSAVE_FILE);
+}
+
+// 对局正常结束（回到菜单或退出程序）时关闭并删除自动存档
+void stopAutosave(void) {
+    if (!autosave) return;
+    gomoku_journal_close(autosave);
+    autosave = NULL;
+    remove(AUTOSAVE_FILE);
+}
+
+// 启动时发现上次异常退出留下的自动存档：恢复成双人对局继续下；
+// 存档停在胜着上（胜后还没回菜单就退出了）时直接进入终局状态
+void recoverAutosave(void) {
+    if (!gomoku_game_recover(gomoku_default_game(), AUTOSAVE_FILE)) return;
+    if (gomoku_move_count() == 0) {
+        remove(AUTOSAVE_FILE);
+        return;
+    }
+    boardSize = gomoku_board_size();
+    boardRule = gomoku_rule();
+    updateVariantLabels();
+    aiPlayer = '\0';
+    appState = STATE_PLAY;
+    winFlag = lastMoveWon() ? 1 : 0;
+    startAutosave();
+    showMessage(winFlag ? "Recovered finished game" : "Recovered unfinished game", 3);
+    SDL_Log("Recovered %d moves from %s", gomoku_move_count(), AUTOSAVE_FILE);
+}
+
+// 主循环每帧在轮到玩家时调用：开始不限时的后台思考，用玩家的思考时间搜索玩家可能的各种应手。
+// alpha-beta 的结果留在共享的置换表里，MCTS 的结果留在搜索树里；玩家落子后 AI 的搜索从这些结果接着算
+void ponder(void) {
+    if (!aiPonder || ponderSearch) return;
+    GomokuSearchLimits limits = {};
+    limits.engine = aiUseMcts ? GOMOKU_ENGINE_MCTS : GOMOKU_ENGINE_ALPHA_BETA;
+    ponderSearch = gomoku_search_start(gomoku_default_game(), &limits, NULL, NULL);
+}
+
+// 玩家在 (row, col) 落子后调用：停止后台思考。猜中玩家的着法时主变例上的结果最多，猜错也照样复用其余应手的结果
+void stopPonder(int row, int col) {
+    if (!ponderSearch) return;
+    GomokuSearchProgress progress;
+    gomoku_search_stop(ponderSearch);
+    int r = -1, c = -1;
+    gomoku_search_wait(ponderSearch, &r, &c, NULL);
+    gomoku_search_poll(ponderSearch, &progress);
+    gomoku_search_destroy(ponderSearch);
+    ponderSearch = NULL;
+    SDL_Log("Ponder %s: expected (%d,%d), got (%d,%d); depth %d, %llu nodes in %d ms",
+        r == row && c == col ? "hit" : "miss", r, c, row, col, progress.depth,
+        (unsigned long long)progress.nodes, progress.timeMs);
+}
+
+// 主循环每帧在绘制之后调用：轮到 AI 时开始异步搜索，界面照常绘制与响应；搜完（或按空格让 AI 立即出手）后落子
+void aiMove(void) {
+    if (!aiSearch) {
+        GomokuSearchLimits limits = {};
+        limits.engine = aiUseMcts ? GOMOKU_ENGINE_MCTS : GOMOKU_ENGINE_ALPHA_BETA;
+        limits.timeMs = AI_THINK_MS;
+        aiSearch = gomoku_search_start(gomoku_default_game(), &limits, NULL, NULL);
+        if (!aiSearch) {
+            showMessage("Out of memory", 2);
+            aiPlayer = '\0';
+        }
+        return;
+    }
+    if (!gomoku_search_done(aiSearch)) return;
+    int r, c;
+    GomokuAiStats stats;
+    GomokuSearchProgress progress;
+    bool found = gomoku_search_wait(aiSearch, &r, &c, &stats);
+    gomoku_search_poll(aiSearch, &progress);
+    cancelAiSearch();
+    if (!found) {
+        showMessage("No moves left", 2);
+        aiPlayer = '\0';
+        return;
+    }
+    if (stats.bookMove) {
+        SDL_Log("AI move (%d,%d): from opening book", r, c);
+    }
+    else if (aiUseMcts) {
+        SDL_Log("AI move (%d,%d): MCTS %llu playouts in %d ms, win rate %.1f%%, %d threads", r, c,
+            (unsigned long long)progress.nodes, progress.timeMs, progress.score / 10.0, stats.threads);
+    }
+    else {
+        SDL_Log("AI move (%d,%d): depth %d, score %d, %llu nodes in %d ms, %d threads, first-move cutoffs %.1f%%, cutoff index %.2f",
+            r, c, stats.depth, stats.score, (unsigned long long)stats.nodes, stats.timeMs, stats.threads,
+            100.0 * stats.firstMoveCutoffRate, stats.averageCutoffIndex);
+    }
+    if (gomoku_make_move(r, c)) {
+        if (gomoku_check_win(r, c)) {
+            winFlag = 1;
+            showMessage("AI wins", 3);
+        }
+        else {
+            gomoku_switch_player();
+        }
+    }
+}
+
+// 在 15/19/20 路之间切换，并更新按钮文字
+void toggleBoardSize(void) {
+    boardSize = boardSize == 15 ? 19 : (boardSize == 19 ? 20 : 15);
+    updateVariantLabels();
+}
+
+// 在各规则之间切换，并更新按钮文字
+void toggleRule(void) {
+    boardRule = (GomokuRule)((boardRule + 1) % 4);
+    updateVariantLabels();
+}
+
+// 按当前选择的路数与规则刷新菜单按钮文字
+void updateVariantLabels(void) {
+    const char* names[4] = { "Freestyle", "Exact Five", "Caro", "Renju" };
+    snprintf(menuButtons[3].label, sizeof(menuButtons[3].label), "Board: %dx%d", boardSize, boardSize);
+    snprintf(menuButtons[4].label, sizeof(menuButtons[4].label), "Rule: %s", names[boardRule]);
+}
+
+// 在 alpha-beta 与蒙特卡洛树搜索之间切换 AI 引擎
+void toggleEngine(void) {
+    aiUseMcts = !aiUseMcts;
+    snprintf(menuButtons[5].label, sizeof(menuButtons[5].label), "Engine: %s", aiUseMcts ? "MCTS" : "Alpha-beta");
+}
+
+// 开关轮到玩家时的后台思考
+void togglePonder(void) {
+    aiPonder = !aiPonder;
+    snprintf(menuButtons[6].label, sizeof(menuButtons[6].label), "Ponder: %s", aiPonder ? "On" : "Off");
 }
 
 // 退出应用
@@ -131,15 +340,40 @@ void exitGame(void) {
     SDL_PushEvent(&ev);
 }
 
-// 撤销一步：调用逻辑层并切换玩家
+// 撤销一步：逻辑层同时恢复轮走方；AI 对战时连同 AI 的应手一起撤销，回到玩家落子前
 void undoMove(void) {
-    if (gomoku_undo_moves()) {
-        gomoku_switch_player();
+    if (gomoku_undo(1)) {
+        if (aiPlayer && gomoku_current_player() == aiPlayer) gomoku_undo(1);
         winFlag = 0;
-        SDL_Log("Undo move, switched player");
+        SDL_Log("Undo move");
+    }
+}
+
+// 重做一步被撤销的棋；AI 对战时连同 AI 的应手一起重做，但玩家这一手已经获胜时不再重做。
+// 重做出的最后一手连成五时回到胜利画面
+void redoMove(void) {
+    if (gomoku_redo(1)) {
+        if (!lastMoveWon() && aiPlayer && gomoku_current_player() == aiPlayer && gomoku_redo_count() > 0) gomoku_redo(1);
+        if (lastMoveWon()) {
+            winFlag = 1;
+            showMessage("Game Over", 3);
+        }
+        SDL_Log("Redo move");
+    }
+    else {
+        showMessage("Nothing to redo", 2);
     }
 }
 
+// 最后一手是否连成了五：逻辑层在重做、恢复时会重新标出最后一手的胜利标记
+bool lastMoveWon(void) {
+    int n = gomoku_move_count();
+    if (n == 0) return false;
+    int r, c;
+    gomoku_get_move(n - 1, &r, &c);
+    return gomoku_get_win_marks()[r][c] != 0;
+}
+
 // 保存游戏到文件
 void saveGame(void) {
     if (gomoku_save("save.txt") != 0) {
@@ -166,33 +400,95 @@ void loadGamePlay(void) {
     }
 }
 
-// 提示功能：逻辑层标记威胁并显示消息
+// 提示线程：对点提示时的局面副本做威胁空间搜索
+static int SDLCALL hintThreadMain(void* data) {
+    (void)data;
+    gomoku_game_threat_search(hintGame, GOMOKU_THREAT_VCT, HINT_NODES, HINT_THINK_MS, &hintResult);
+    SDL_AtomicSet(&hintDone, 1);
+    return 0;
+}
+
+// 提示功能：开局库里有当前局面时直接标出库里最好的着法；否则在后台为当前玩家做 VCF/VCT 威胁空间搜索，
+// 结果由 pollHint() 显示
 void hintMove(void) {
-    gomoku_detect_threats();
-    showMessage("Hint displayed", 2);
+    char msg[128];
+    GomokuBookMove bookMove;
+    if (hintThread) {
+        showMessage("Searching...", 1);
+        return;
+    }
+    if (book && gomoku_book_probe(book, gomoku_default_game(), &bookMove, 1) > 0) {
+        memset(&hint, 0, sizeof(hint));
+        hint.length = 1;
+        hint.moves[0][0] = bookMove.row;
+        hint.moves[0][1] = bookMove.col;
+        hintShown = true;
+        hintHash = gomoku_position_hash();
+        snprintf(msg, sizeof(msg), "Book: play (%d,%d), %u games, scored %.0f%%", bookMove.row, bookMove.col,
+            bookMove.games, 100.0 * (bookMove.wins + 0.5 * bookMove.draws) / bookMove.games);
+        showMessage(msg, 3);
+        SDL_Log("Hint: book move (%d,%d), %u games", bookMove.row, bookMove.col, bookMove.games);
+        return;
+    }
+    // 搜索用棋谱复制出的副本，主线程照常落子、悔棋也不影响它
+    unsigned char record[GOMOKU_RECORD_MAX_BYTES];
+    int length = gomoku_game_encode(gomoku_default_game(), record, sizeof(record));
+    hintGame = gomoku_game_create_variant(gomoku_board_size(), gomoku_rule());
+    if (!hintGame || !gomoku_game_decode(hintGame, record, length)) {
+        gomoku_game_destroy(hintGame);
+        hintGame = NULL;
+        showMessage("Out of memory", 2);
+        return;
+    }
+    hintShown = false;
+    hintHash = gomoku_position_hash();
+    SDL_AtomicSet(&hintDone, 0);
+    hintThread = SDL_CreateThread(hintThreadMain, "gomoku-hint", NULL);
+    if (!hintThread) {
+        gomoku_game_destroy(hintGame);
+        hintGame = NULL;
+        return;
+    }
+    showMessage("Searching...", 1);
 }
 
-// 进入回放模式：读取历史步数，保存到 reviewMoves，进入 STATE_REVIEW
+// 主循环每帧调用：提示搜索结束后标出必胜序列；局面已经变了时只记日志，不再显示
+void pollHint(void) {
+    if (!hintThread || !SDL_AtomicGet(&hintDone)) return;
+    SDL_WaitThread(hintThread, NULL);
+    hintThread = NULL;
+    gomoku_game_destroy(hintGame);
+    hintGame = NULL;
+    hint = hintResult;
+    SDL_Log("Hint: status %d, %d moves, %llu nodes in %d ms", hint.status, hint.length,
+        (unsigned long long)hint.nodes, hint.timeMs);
+    if (appState != STATE_PLAY || hintHash != gomoku_position_hash()) return;
+    hintShown = hint.status == GOMOKU_THREAT_WIN;
+    if (hintShown) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "Forced win in %d: play (%d,%d)", (hint.length + 1) / 2, hint.moves[0][0], hint.moves[0][1]);
+        showMessage(msg, 3);
+    }
+    else {
+        gomoku_detect_threats();
+        showMessage(hint.status == GOMOKU_THREAT_UNKNOWN ? "No forced win found in time" : "No forced win", 2);
+    }
+}
+
+// 进入回放模式：撤销全部棋步回到第0步，之后用重做/撤销逐步前进后退，进入 STATE_REVIEW
 void replayGame(void) {
     savedMoveCount = gomoku_move_count();
     SDL_Log("Entering review: savedMoveCount=%d", savedMoveCount);
-    if (savedMoveCount > 0 && savedMoveCount <= MAX_MOVES) {
-        for (int i = 0; i < savedMoveCount; ++i) {
-            int r, c;
-            gomoku_get_move(i, &r, &c);
-            reviewMoves[i][0] = r;
-            reviewMoves[i][1] = c;
-            SDL_Log("Stored move %d: (%d,%d)", i, r, c);
-        }
+    if (savedMoveCount > 0) {
+        gomoku_undo(savedMoveCount);
         appState = STATE_REVIEW;
         reviewStep = 0;
         winFlag = 0;
-        applyReviewSteps();
         showMessage("Review mode: step 0", 2);
     }
     else {
         showMessage("No moves to replay", 2);
-        SDL_Log("No moves to replay or too many moves");
+        SDL_Log("No moves to replay");
     }
 }
 
@@ -204,12 +500,12 @@ void restartGame(void) {
 }
 
 // ----------------- 回放相关函数 -----------------
-// 初始化回放按钮，包含 Prev, Next, Restart, Exit Review
+// 初始化回放按钮，包含 Prev, Next, Restart, Prove, Exit Review
 void setupReviewButtons(void) {
-    const char* labels[4] = { "Prev", "Next", "Restart", "Exit" };
-    void (*cbs[4])(void) = { reviewPrev, reviewNext, reviewRestart, reviewExit };
+    const char* labels[REVIEW_BUTTONS] = { "Prev", "Next", "Restart", "Prove", "Exit" };
+    void (*cbs[REVIEW_BUTTONS])(void) = { reviewPrev, reviewNext, reviewRestart, reviewProve, reviewExit };
     int bw = 90, bh = 35;
-    for (int i = 0; i < 4; ++i) {
+    for (int i = 0; i < REVIEW_BUTTONS; ++i) {
         reviewButtons[i].rect.x = 10 + i * (bw + 10);
         reviewButtons[i].rect.y = BOARD_PIXELS + 20;
         reviewButtons[i].rect.w = bw;
@@ -220,27 +516,12 @@ void setupReviewButtons(void) {
     }
 }
 
-// 根据 reviewStep 重放前 reviewStep 步棋，黑白交替
-void applyReviewSteps(void) {
-    gomoku_init();  // 重置棋盘
-    SDL_Log("Applying review steps: reviewStep=%d", reviewStep);
-    for (int i = 0; i < reviewStep; ++i) {
-        int r = reviewMoves[i][0];
-        int c = reviewMoves[i][1];
-        if (!gomoku_make_move(r, c)) {
-            SDL_Log("Failed to apply stored move %d: (%d,%d)", i, r, c);
-            break;
-        }
-        gomoku_switch_player();  // 交替落子
-    }
-}
-
 // 回放上一步
 void reviewPrev(void) {
     SDL_Log("Clicked Prev: current reviewStep=%d", reviewStep);
     if (reviewStep > 0) {
         reviewStep--;
-        applyReviewSteps();
+        gomoku_undo(1);
         char buf[64];
         snprintf(buf, sizeof(buf), "Review: step %d", reviewStep);
         showMessage(buf, 2);
@@ -256,7 +537,7 @@ void reviewNext(void) {
     SDL_Log("Clicked Next: current reviewStep=%d, savedMoveCount=%d", reviewStep, savedMoveCount);
     if (reviewStep < savedMoveCount) {
         reviewStep++;
-        applyReviewSteps();
+        gomoku_redo(1);
         char buf[64];
         snprintf(buf, sizeof(buf), "Review: step %d", reviewStep);
         showMessage(buf, 2);
@@ -270,25 +551,63 @@ void reviewNext(void) {
 // 回放重置到第0步
 void reviewRestart(void) {
     SDL_Log("Clicked Restart in review");
+    gomoku_undo(reviewStep);
     reviewStep = 0;
-    applyReviewSteps();
     showMessage("Review restarted", 2);
 }
 
+// 证明线程：对回放到的局面做证明数搜索
+static int SDLCALL proofThreadMain(void* data) {
+    (void)data;
+    gomoku_prove(PROOF_NODES, PROOF_TABLE_MB, &proofStats);
+    SDL_AtomicSet(&proofDone, 1);
+    return 0;
+}
+
+// 在后台证明当前回放局面的胜负，结果由 pollProof() 显示
+void reviewProve(void) {
+    SDL_AtomicSet(&proofDone, 0);
+    proofThread = SDL_CreateThread(proofThreadMain, "gomoku-proof", NULL);
+    if (proofThread) showMessage("Proving...", 60);
+}
+
+// 主循环每帧调用：证明结束后显示结果
+void pollProof(void) {
+    if (!proofThread || !SDL_AtomicGet(&proofDone)) return;
+    SDL_WaitThread(proofThread, NULL);
+    proofThread = NULL;
+    char buf[128];
+    char side = gomoku_current_player();
+    if (proofStats.result == GOMOKU_PROOF_WIN) {
+        snprintf(buf, sizeof(buf), "%c wins: play (%d,%d), proof tree %llu nodes", side, proofStats.row, proofStats.col,
+            (unsigned long long)proofStats.proofSize);
+    }
+    else if (proofStats.result == GOMOKU_PROOF_LOSS) {
+        snprintf(buf, sizeof(buf), "%c loses, proof tree %llu nodes", side, (unsigned long long)proofStats.proofSize);
+    }
+    else {
+        snprintf(buf, sizeof(buf), "Unknown after %llu nodes", (unsigned long long)proofStats.nodes);
+    }
+    showMessage(buf, 5);
+    SDL_Log("Proof: result %d, %llu nodes, proof tree %llu, %d ms", proofStats.result,
+        (unsigned long long)proofStats.nodes, (unsigned long long)proofStats.proofSize, proofStats.timeMs);
+}
+
 // 退出回放，返回到菜单
 void reviewExit(void) {
     SDL_Log("Clicked Exit Review");
     appState = STATE_MENU;
+    stopAutosave();
     showMessage("Exited review mode", 2);
 }
 
 // ----------------- 按钮设置 -----------------
 void setupMenuButtons(void) {
-    const char* labels[4] = { "Start Game", "Load Game", "AI Battle", "Exit" };
-    void (*cbs[4])(void) = { startGame, loadGame, aiBattle, exitGame };
+    const char* labels[MENU_BUTTONS] = { "Start Game", "Load Game", "AI Battle", "Board: 15x15", "Rule: Freestyle", "Engine: Alpha-beta", "Ponder: On", "Exit" };
+    void (*cbs[MENU_BUTTONS])(void) = { startGame, loadGame, aiBattle, toggleBoardSize, toggleRule, toggleEngine, togglePonder, exitGame };
     int w = 180, h = 50;
     int x0 = (WINDOW_WIDTH - w) / 2;
-    for (int i = 0; i < 4; ++i) {
+    for (int i = 0; i < MENU_BUTTONS; ++i) {
         menuButtons[i].rect.x = x0;
         menuButtons[i].rect.y = 150 + i * (h + 20);
         menuButtons[i].rect.w = w;
@@ -299,10 +618,10 @@ void setupMenuButtons(void) {
 }
 
 void setupGameButtons(void) {
-    const char* labels[5] = { "Undo", "Save", "Load", "Hint", "Exit" };
-    void (*cbs[5])(void) = { undoMove, saveGame, loadGamePlay, hintMove, exitGame };
+    const char* labels[GAME_BUTTONS] = { "Undo", "Redo", "Save", "Load", "Hint", "Exit" };
+    void (*cbs[GAME_BUTTONS])(void) = { undoMove, redoMove, saveGame, loadGamePlay, hintMove, exitGame };
     int bw = 90, bh = 35;
-    for (int i = 0; i < 5; ++i) {
+    for (int i = 0; i < GAME_BUTTONS; ++i) {
         gameButtons[i].rect.x = 10 + i * (bw + 10);
         gameButtons[i].rect.y = BOARD_PIXELS + 20;
         gameButtons[i].rect.w = bw;
@@ -331,7 +650,7 @@ void setupWinButtons(void) {
 void showMenu(void) {
     SDL_SetRenderDrawColor(renderer, 100, 149, 237, 255);
     SDL_RenderClear(renderer);
-    for (int i = 0; i < 4; ++i) {
+    for (int i = 0; i < MENU_BUTTONS; ++i) {
         drawButton(&menuButtons[i]);
     }
     SDL_RenderPresent(renderer);
@@ -345,13 +664,15 @@ void drawBoard(bool reviewMode) {
 
     // 逻辑层检测威胁、高亮胜利
     gomoku_detect_threats();
-    const int (*winM)[BOARD_SIZE] = gomoku_get_win_marks();
-    const int (*thM)[BOARD_SIZE] = gomoku_get_threat_marks();
+    const int (*winM)[GOMOKU_MAX_SIZE] = gomoku_get_win_marks();
+    const int (*thM)[GOMOKU_MAX_SIZE] = gomoku_get_threat_marks();
+    int n = gomoku_board_size();
+    int cs = cellSize();
 
     // 绘制格子和棋子
-    for (int i = 0; i < BOARD_SIZE; ++i) {
-        for (int j = 0; j < BOARD_SIZE; ++j) {
-            SDL_Rect cell = { j * CELL_SIZE, i * CELL_SIZE, CELL_SIZE, CELL_SIZE };
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            SDL_Rect cell = { j * cs, i * cs, cs, cs };
             if (winM && winM[i][j]) {
                 SDL_SetRenderDrawColor(renderer, 144, 238, 144, 255);
                 SDL_RenderFillRect(renderer, &cell);
@@ -364,7 +685,7 @@ void drawBoard(bool reviewMode) {
             SDL_RenderDrawRect(renderer, &cell);
             char ch = gomoku_board_cell(i, j);
             if (ch == 'X' || ch == 'O') {
-                SDL_Rect p = { cell.x + 4, cell.y + 4, CELL_SIZE - 8, CELL_SIZE - 8 };
+                SDL_Rect p = { cell.x + 4, cell.y + 4, cs - 8, cs - 8 };
                 if (ch == 'X') SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
                 else SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
                 SDL_RenderFillRect(renderer, &p);
@@ -374,12 +695,41 @@ void drawBoard(bool reviewMode) {
         }
     }
 
+    // 连珠规则下轮到黑方时，用红叉标出禁手点
+    if (!reviewMode) {
+        int forbidden[MAX_MOVES][2];
+        int nf = gomoku_forbidden_moves(forbidden, MAX_MOVES);
+        SDL_SetRenderDrawColor(renderer, 220, 20, 60, 255);
+        for (int k = 0; k < nf; ++k) {
+            int x0 = forbidden[k][1] * cs + cs / 4, y0 = forbidden[k][0] * cs + cs / 4;
+            int x1 = x0 + cs / 2, y1 = y0 + cs / 2;
+            SDL_RenderDrawLine(renderer, x0, y0, x1, y1);
+            SDL_RenderDrawLine(renderer, x0, y1, x1, y0);
+        }
+    }
+
+    // 提示的必胜序列：走棋方的着法标红色序号，对方的应手标蓝色序号
+    if (!reviewMode && hintShown && hintHash == gomoku_position_hash()) {
+        for (int k = 0; k < hint.length; ++k) {
+            char num[8];
+            snprintf(num, sizeof(num), "%d", k + 1);
+            SDL_Color nc = { (Uint8)(k % 2 ? 0 : 200), 0, (Uint8)(k % 2 ? 200 : 0), 255 };
+            SDL_Surface* ns = TTF_RenderText_Blended(font, num, nc);
+            if (!ns) continue;
+            SDL_Texture* nt = SDL_CreateTextureFromSurface(renderer, ns);
+            SDL_Rect nd = { hint.moves[k][1] * cs + (cs - ns->w) / 2, hint.moves[k][0] * cs + (cs - ns->h) / 2, ns->w, ns->h };
+            SDL_RenderCopy(renderer, nt, NULL, &nd);
+            SDL_FreeSurface(ns);
+            SDL_DestroyTexture(nt);
+        }
+    }
+
     // 高亮最后一步
     int moves = gomoku_move_count();
     if (!reviewMode && moves > 0) {
         int lr, lc;
         gomoku_get_move(moves - 1, &lr, &lc);
-        SDL_Rect last = { lc * CELL_SIZE, lr * CELL_SIZE, CELL_SIZE, CELL_SIZE };
+        SDL_Rect last = { lc * cs, lr * cs, cs, cs };
         SDL_SetRenderDrawColor(renderer, 255, 215, 0, 255);
         for (int i = 0; i < 3; ++i) {
             SDL_RenderDrawRect(renderer, &last);
@@ -393,6 +743,24 @@ void drawBoard(bool reviewMode) {
     // 显示当前玩家
     char buf[128];
     snprintf(buf, sizeof(buf), "Turn: %c", gomoku_current_player());
+    if (aiSearch) {
+        // AI 思考中：显示目前的深度、分数、最佳着法与速度（按空格立即出手）
+        GomokuSearchProgress progress;
+        gomoku_search_poll(aiSearch, &progress);
+        if (progress.row >= 0) {
+            snprintf(buf, sizeof(buf), "Turn: %c   AI thinking: depth %d, score %d, best (%d,%d), %llu kN/s  [Space: move now]",
+                gomoku_current_player(), progress.depth, progress.score, progress.row, progress.col,
+                (unsigned long long)(progress.nodesPerSecond / 1000));
+        }
+    }
+    else if (ponderSearch) {
+        GomokuSearchProgress progress;
+        gomoku_search_poll(ponderSearch, &progress);
+        if (progress.row >= 0) {
+            snprintf(buf, sizeof(buf), "Turn: %c   AI pondering: depth %d, expects (%d,%d)",
+                gomoku_current_player(), progress.depth, progress.row, progress.col);
+        }
+    }
     SDL_Color tc = { 0,0,0,255 };
     SDL_Surface* bs = TTF_RenderText_Blended(font, buf, tc);
     if (bs) {
@@ -405,13 +773,13 @@ void drawBoard(bool reviewMode) {
 
     // 绘制按钮
     if (appState == STATE_REVIEW) {
-        for (int i = 0; i < 4; ++i) drawButton(&reviewButtons[i]);
+        for (int i = 0; i < REVIEW_BUTTONS; ++i) drawButton(&reviewButtons[i]);
     }
     else if (winFlag) {
         for (int i = 0; i < 3; ++i) drawButton(&winButtons[i]);
     }
     else {
-        for (int i = 0; i < 5; ++i) drawButton(&gameButtons[i]);
+        for (int i = 0; i < GAME_BUTTONS; ++i) drawButton(&gameButtons[i]);
     }
 
     // 渲染短消息
@@ -443,10 +811,11 @@ void handlePlayEvent(SDL_Event* e) {
         SDL_Point pt = { mx, my };
         if (appState == STATE_PLAY) {
             // 游戏中点击棋盘落子或点击按钮
-            if (!winFlag && my < BOARD_PIXELS) {
-                int row = my / CELL_SIZE;
-                int col = mx / CELL_SIZE;
+            if (!winFlag && my < BOARD_PIXELS && gomoku_current_player() != aiPlayer) {
+                int row = my / cellSize();
+                int col = mx / cellSize();
                 if (gomoku_make_move(row, col)) {
+                    stopPonder(row, col);
                     if (gomoku_check_win(row, col)) {
                         winFlag = 1;
                         showMessage("Game Over", 3);
@@ -456,6 +825,9 @@ void handlePlayEvent(SDL_Event* e) {
                         gomoku_switch_player();
                     }
                 }
+                else if (gomoku_is_forbidden(row, col)) {
+                    showMessage("Forbidden move", 2);
+                }
             }
             else {
                 // 点击游戏按钮或胜利后的按钮
@@ -467,8 +839,13 @@ void handlePlayEvent(SDL_Event* e) {
                     }
                 }
                 else {
-                    for (int i = 0; i < 5; ++i) {
+                    for (int i = 0; i < GAME_BUTTONS; ++i) {
                         if (SDL_PointInRect(&pt, &gameButtons[i].rect)) {
+                            // AI 思考时按悔棋、重做、读档会先放弃这次搜索（与后台思考）；主循环再按新局面重新开始
+                            if ((aiSearch || ponderSearch) && (gameButtons[i].onClick == undoMove || gameButtons[i].onClick == redoMove
+                                || gameButtons[i].onClick == loadGamePlay)) {
+                                cancelAiSearch();
+                            }
                             gameButtons[i].onClick();
                         }
                     }
@@ -478,15 +855,24 @@ void handlePlayEvent(SDL_Event* e) {
         else if (appState == STATE_REVIEW) {
             // 回放模式下点击按钮
             SDL_Log("Mouse click at (%d,%d) in REVIEW", mx, my);
-            for (int i = 0; i < 4; ++i) {
+            for (int i = 0; i < REVIEW_BUTTONS; ++i) {
                 if (SDL_PointInRect(&pt, &reviewButtons[i].rect)) {
-                    reviewButtons[i].onClick();
+                    if (proofThread) {
+                        showMessage("Proving...", 1);
+                    }
+                    else {
+                        reviewButtons[i].onClick();
+                    }
                 }
             }
         }
     }
     else if (e->type == SDL_KEYDOWN) {
-        if (appState == STATE_REVIEW) {
+        if (appState == STATE_PLAY && aiSearch && e->key.keysym.sym == SDLK_SPACE) {
+            // 空格：让 AI 停止思考，立即走到目前为止的最佳着法
+            gomoku_search_stop(aiSearch);
+        }
+        else if (appState == STATE_REVIEW && !proofThread) {
             // 键盘也支持回放控制: 左/右/重启/退出
             if (e->key.keysym.sym == SDLK_LEFT) {
                 reviewPrev();
@@ -509,6 +895,16 @@ int main(int argc, char* argv[]) {
     // 初始化SDL和TTF
     SDL_Init(SDL_INIT_VIDEO);
     TTF_Init();
+    gomoku_ai_set_threads(0);  // AI 使用全部逻辑核心
+    // 有网络权重文件时 AI 对战改用神经网络评估
+    if (gomoku_nnue_load("gomoku.nnue")) SDL_Log("Loaded NNUE evaluator from gomoku.nnue");
+    // 有开局库时 AI 与提示在开局阶段直接走库里的着法（库只用于建库时的尺寸与规则）
+    book = gomoku_book_open(BOOK_FILE);
+    if (book) {
+        gomoku_ai_set_book(book);
+        SDL_Log("Loaded opening book %s: %llu positions, %dx%d, %d plies", BOOK_FILE,
+            (unsigned long long)gomoku_book_entries(book), gomoku_book_board_size(book), gomoku_book_board_size(book), gomoku_book_plies(book));
+    }
     window = SDL_CreateWindow("Gomoku", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
         WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
     renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
@@ -527,6 +923,7 @@ int main(int argc, char* argv[]) {
     setupGameButtons();
     setupWinButtons();
     setupReviewButtons(); 
+    recoverAutosave();
 
     bool running = true;
     SDL_Event e;
@@ -537,7 +934,7 @@ int main(int argc, char* argv[]) {
             while (SDL_PollEvent(&e)) {
                 if (e.type == SDL_MOUSEBUTTONDOWN) {
                     SDL_Point pt = { e.button.x, e.button.y };
-                    for (int i = 0; i < 4; ++i) {
+                    for (int i = 0; i < MENU_BUTTONS; ++i) {
                         if (SDL_PointInRect(&pt, &menuButtons[i].rect)) {
                             menuButtons[i].onClick();
                         }
@@ -557,11 +954,26 @@ int main(int argc, char* argv[]) {
                 handlePlayEvent(&e);
             }
             drawBoard(appState == STATE_REVIEW);
+            if (appState == STATE_PLAY && !winFlag && aiPlayer) {
+                if (gomoku_current_player() == aiPlayer) aiMove();
+                else ponder();
+            }
+            // 落子、悔棋、重做、读档后把变化追加到自动存档；局面没变时不写文件
+            if (appState == STATE_PLAY && autosave) gomoku_journal_record(autosave, gomoku_default_game());
+            pollProof();
+            pollHint();
             SDL_Delay(16);
         }
     }
 
     // 清理
+    cancelAiSearch();
+    stopAutosave();
+    if (proofThread) SDL_WaitThread(proofThread, NULL);
+    if (hintThread) SDL_WaitThread(hintThread, NULL);
+    gomoku_game_destroy(hintGame);
+    gomoku_ai_set_book(NULL);
+    gomoku_book_close(book);
     TTF_CloseFont(font);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
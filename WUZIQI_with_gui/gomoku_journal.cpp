@@ -0,0 +1,143 @@
+#include "gomoku_logic.h"
+#include "gomoku_mmap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 自动存档日志：只追加的走子记录。文件头 8 字节：魔数 "GMKJ"、版本、尺寸、规则、保留字节；
+// 之后每条记录 2 字节小端：低 9 位为格子编号 r * size + c 加 1（JOURNAL_UNDO 表示撤销一手），
+// 高 7 位是由记录序号与低 9 位算出的校验位。崩溃时写了一半的末尾记录、或文件系统留下的零字节，
+// 都会因长度不足或校验位不符被当作日志结尾丢弃。
+// 每次 gomoku_journal_record() 都把新记录交给操作系统（进程崩溃不会丢），fsync 则按 syncEvery 条合并一次。
+
+#define JOURNAL_MAGIC "GMKJ"
+#define JOURNAL_VERSION 1
+#define JOURNAL_HEADER_BYTES 8
+#define JOURNAL_UNDO 0x1FF
+#define JOURNAL_MAX_MOVES (GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE)
+
+struct GomokuJournal {
+    FILE* fp;
+    int size;
+    int syncEvery;
+    int pending;         // 已写入但还没有 fsync 的记录数
+    uint32_t records;    // 文件中的记录总数
+    int count;           // 日志当前记录到的步数
+    unsigned char line[JOURNAL_MAX_MOVES][2];
+};
+
+static unsigned journal_check(uint32_t index, unsigned code) {
+    return ((code ^ (index * 0x9E3779B1u)) * 0x85EBCA6Bu) >> 25;
+}
+
+GomokuJournal* gomoku_journal_open(const char* filename, const GomokuGame* g, int syncEvery) {
+    GomokuJournal* j = (GomokuJournal*)malloc(sizeof(GomokuJournal));
+    if (!j) return NULL;
+    j->fp = fopen(filename, "wb");
+    if (!j->fp) {
+        free(j);
+        return NULL;
+    }
+    j->size = gomoku_game_board_size(g);
+    j->syncEvery = syncEvery;
+    j->pending = 0;
+    j->records = 0;
+    j->count = 0;
+    unsigned char header[JOURNAL_HEADER_BYTES] = { 0 };
+    memcpy(header, JOURNAL_MAGIC, 4);
+    header[4] = JOURNAL_VERSION;
+    header[5] = (unsigned char)j->size;
+    header[6] = (unsigned char)gomoku_game_rule(g);
+    if (fwrite(header, 1, sizeof(header), j->fp) != sizeof(header)
+        || !gomoku_journal_record(j, g) || !gomoku_journal_sync(j)) {
+        fclose(j->fp);
+        free(j);
+        return NULL;
+    }
+    return j;
+}
+
+bool gomoku_journal_record(GomokuJournal* j, const GomokuGame* g) {
+    if (gomoku_game_board_size(g) != j->size) return false;
+    int count = gomoku_game_move_count(g);
+    // 与日志中的走子比较，找出分叉点：之后的旧着法记为撤销，再追加新着法
+    int same = 0;
+    while (same < j->count && same < count) {
+        int r, c;
+        gomoku_game_get_move(g, same, &r, &c);
+        if (j->line[same][0] != r || j->line[same][1] != c) break;
+        same++;
+    }
+    if (same == j->count && same == count) return true;
+    unsigned char buffer[2 * 2 * JOURNAL_MAX_MOVES];
+    int n = 0;
+    uint32_t index = j->records;
+    for (int i = j->count; i > same; i--) {
+        unsigned v = JOURNAL_UNDO | (journal_check(index++, JOURNAL_UNDO) << 9);
+        buffer[n++] = (unsigned char)(v & 0xFF);
+        buffer[n++] = (unsigned char)(v >> 8);
+    }
+    for (int i = same; i < count; i++) {
+        int r, c;
+        gomoku_game_get_move(g, i, &r, &c);
+        unsigned code = (unsigned)(r * j->size + c + 1);
+        unsigned v = code | (journal_check(index++, code) << 9);
+        buffer[n++] = (unsigned char)(v & 0xFF);
+        buffer[n++] = (unsigned char)(v >> 8);
+        j->line[i][0] = (unsigned char)r;
+        j->line[i][1] = (unsigned char)c;
+    }
+    j->count = count;
+    if (fwrite(buffer, 1, n, j->fp) != (size_t)n || fflush(j->fp) != 0) return false;
+    j->pending += (int)(index - j->records);
+    j->records = index;
+    if (j->syncEvery > 0 && j->pending >= j->syncEvery) return gomoku_journal_sync(j);
+    return true;
+}
+
+bool gomoku_journal_sync(GomokuJournal* j) {
+    if (!file_sync(j->fp)) return false;
+    j->pending = 0;
+    return true;
+}
+
+void gomoku_journal_close(GomokuJournal* j) {
+    if (!j) return;
+    gomoku_journal_sync(j);
+    fclose(j->fp);
+    free(j);
+}
+
+bool gomoku_game_recover(GomokuGame* g, const char* filename) {
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) return false;
+    unsigned char header[JOURNAL_HEADER_BYTES];
+    if (fread(header, 1, sizeof(header), fp) != sizeof(header) || memcmp(header, JOURNAL_MAGIC, 4) != 0
+        || header[4] != JOURNAL_VERSION || !gomoku_game_init_variant(g, header[5], (GomokuRule)header[6])) {
+        fclose(fp);
+        return false;
+    }
+    int size = header[5];
+    int moves[JOURNAL_MAX_MOVES][2];
+    int count = 0;
+    unsigned char rec[2];
+    for (uint32_t index = 0; fread(rec, 1, 2, fp) == 2; index++) {
+        unsigned v = rec[0] | (rec[1] << 8), code = v & 0x1FF;
+        if ((v >> 9) != journal_check(index, code)) break;
+        if (code == JOURNAL_UNDO) {
+            if (count == 0) break;
+            count--;
+        }
+        else {
+            int cell = (int)code - 1;
+            if (cell < 0 || cell >= size * size || count == size * size) break;
+            moves[count][0] = cell / size;
+            moves[count][1] = cell % size;
+            count++;
+        }
+    }
+    fclose(fp);
+    // 重放到第一手不合法的着法为止，得到的仍是一局完整的前缀
+    gomoku_game_load_moves(g, moves, count);
+    return true;
+}
@@ -1,77 +1,227 @@
 #include "gomoku_logic.h"
+#include "gomoku_moves.h"
+#include "gomoku_symmetry.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#define _CRT_SECURE_NO_WARNINGS 
-static char board_internal[GOMOKU_SIZE][GOMOKU_SIZE];
-static int moveHistory_internal[GOMOKU_SIZE * GOMOKU_SIZE][2];
-static int moveCount_internal;
-static char currentPlayer_internal;
-static int winMarks_internal[GOMOKU_SIZE][GOMOKU_SIZE];
-static int threatMarks_internal[GOMOKU_SIZE][GOMOKU_SIZE];
-static bool touchedFlag_internal;
-static char touchedPlayer_internal;
+#include <stdint.h>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+#define _CRT_SECURE_NO_WARNINGS
+
+// 旧的全局接口都转发到这个默认实例
+static GomokuGame defaultGame_internal;
+
+// Zobrist 随机键，编译期由 splitmix64 生成，保证不同进程/机器上同一局面的哈希一致
+static constexpr uint64_t splitmix64_internal(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static constexpr ZobristKeys make_zobrist_internal() {
+    ZobristKeys z = {};
+    uint64_t state = 0x5A0B21571ull;
+    for (int p = 0; p < 2; p++)
+        for (int i = 0; i < GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE; i++)
+            z.key[p][i] = splitmix64_internal(state);
+    return z;
+}
 
+static constexpr ZobristKeys zobristInit_internal = make_zobrist_internal();
+extern const ZobristKeys gomoku_zobrist_keys = zobristInit_internal;
 
-static bool is_valid_move_internal(int r, int c) {
-    return (r >= 0 && r < GOMOKU_SIZE && c >= 0 && c < GOMOKU_SIZE && board_internal[r][c] == ' ');
+template <int N>
+static bool is_valid_move_internal(const GomokuGame* g, int r, int c) {
+    return (r >= 0 && r < N && c >= 0 && c < N
+        && !board_has_stone(g, 0, r, c) && !board_has_stone(g, 1, r, c));
 }
 
 
-void gomoku_init(void) {
-    for (int i = 0; i < GOMOKU_SIZE; i++) {
-        for (int j = 0; j < GOMOKU_SIZE; j++) {
-            board_internal[i][j] = ' ';
-            winMarks_internal[i][j] = 0;
-            threatMarks_internal[i][j] = 0;
-        }
+static bool is_supported_size_internal(int size) {
+    return size == 15 || size == 19 || size == 20;
+}
+
+
+static bool is_supported_rule_internal(GomokuRule rule) {
+    return rule >= GOMOKU_RULE_FREESTYLE && rule <= GOMOKU_RULE_RENJU;
+}
+
+
+// 重新开局时保留已启用的神经网络评估（网络只适用于别的尺寸时关闭），累加器回到空棋盘
+static void reset_internal(GomokuGame* g, int size, GomokuRule rule) {
+    const NnueNetwork* nnue = g->nnue;
+    memset(g, 0, sizeof(*g));
+    g->size = size;
+    g->rule = rule;
+    g->currentPlayer = 'X';
+    g->touchedPlayer = '\0';
+    if (nnue && (nnue->boardSize == 0 || nnue->boardSize == size)) {
+        g->nnue = nnue;
+        nnue_refresh(nnue, g->nnueAcc, g);
     }
-    moveCount_internal = 0;
-    currentPlayer_internal = 'X';
-    touchedFlag_internal = false;
-    touchedPlayer_internal = '\0';
 }
 
 
-bool gomoku_make_move(int row, int col) {
-    if (!is_valid_move_internal(row, col)) {
+GomokuGame* gomoku_game_create(void) {
+    return gomoku_game_create_sized(GOMOKU_SIZE);
+}
+
+
+GomokuGame* gomoku_game_create_sized(int size) {
+    return gomoku_game_create_variant(size, GOMOKU_RULE_FREESTYLE);
+}
+
+
+GomokuGame* gomoku_game_create_variant(int size, GomokuRule rule) {
+    if (!is_supported_size_internal(size) || !is_supported_rule_internal(rule)) return NULL;
+#ifdef _MSC_VER
+    GomokuGame* g = (GomokuGame*)_aligned_malloc(sizeof(GomokuGame), GAME_ALIGN);
+#else
+    GomokuGame* g = NULL;
+    if (posix_memalign((void**)&g, GAME_ALIGN, sizeof(GomokuGame)) != 0) g = NULL;
+#endif
+    if (!g) return NULL;
+    g->nnue = NULL;
+    reset_internal(g, size, rule);
+    return g;
+}
+
+
+void gomoku_game_destroy(GomokuGame* g) {
+    if (!g || g == &defaultGame_internal) return;
+#ifdef _MSC_VER
+    _aligned_free(g);
+#else
+    free(g);
+#endif
+}
+
+
+GomokuGame* gomoku_default_game(void) {
+    return &defaultGame_internal;
+}
+
+
+void gomoku_game_init(GomokuGame* g) {
+    reset_internal(g, gomoku_game_board_size(g), gomoku_game_rule(g));
+}
+
+
+bool gomoku_game_init_sized(GomokuGame* g, int size) {
+    return gomoku_game_init_variant(g, size, gomoku_game_rule(g));
+}
+
+
+bool gomoku_game_init_variant(GomokuGame* g, int size, GomokuRule rule) {
+    if (!is_supported_size_internal(size) || !is_supported_rule_internal(rule)) return false;
+    reset_internal(g, size, rule);
+    return true;
+}
+
+
+int gomoku_game_board_size(const GomokuGame* g) {
+    return is_supported_size_internal(g->size) ? g->size : GOMOKU_SIZE;
+}
+
+
+GomokuRule gomoku_game_rule(const GomokuGame* g) {
+    return is_supported_rule_internal(g->rule) ? g->rule : GOMOKU_RULE_FREESTYLE;
+}
+
+
+
+
+// 以当前玩家的视角在 (row,col) 找五连并刷新 winMarks；越界时清空标记
+template <int N, class Rule>
+static bool mark_win_internal(GomokuGame* g, int row, int col) {
+    WinState w = {};
+    bool won = false;
+    if (row >= 0 && row < N && col >= 0 && col < N) {
+        won = board_find_win<N, Rule>(g, board_player_index(g->currentPlayer), row, col, &w);
+    }
+    board_show_win<N>(g, w);
+    return won;
+}
+
+template <int N, class Rule>
+static bool make_move_internal(GomokuGame* g, int row, int col) {
+    if (!is_valid_move_internal<N>(g, row, col)) {
+        return false;
+    }
+    if (Rule::hasForbidden && g->currentPlayer == 'X' && renju_is_forbidden<N>(g, row, col)) {
+        return false;
+    }
+    board_do_move<N, Rule>(g, row, col);
+    mark_win_internal<N, Rule>(g, row, col);
+    return true;
+}
+
+bool gomoku_game_make_move(GomokuGame* g, int row, int col) {
+    GOMOKU_DISPATCH(g, make_move_internal, g, row, col);
+}
+
+
+// 逐手按差分撤销，最后把胜利标记恢复成最早撤销的那一手落子前的样子
+template <int N>
+static bool undo_internal(GomokuGame* g, int plies) {
+    if (plies < 1 || plies > g->moveCount) {
         return false;
     }
-    board_internal[row][col] = currentPlayer_internal;
-    moveHistory_internal[moveCount_internal][0] = row;
-    moveHistory_internal[moveCount_internal][1] = col;
-    moveCount_internal++;
-    gomoku_mark_win(row, col);
+    for (int i = 0; i < plies; i++) {
+        board_undo_move<N>(g);
+    }
+    board_show_win<N>(g, g->deltas[g->moveCount].winBefore);
     return true;
 }
 
+bool gomoku_game_undo(GomokuGame* g, int plies) {
+    GOMOKU_DISPATCH_SIZE(g, undo_internal, g, plies);
+}
 
-bool gomoku_undo_moves(void) {
-    if (moveCount_internal < 2) {
+
+bool gomoku_game_undo_moves(GomokuGame* g) {
+    return gomoku_game_undo(g, 2);
+}
+
+
+// 逐手按差分重做；胜利标记按最后一手落子方重新判定（只看经过该格的四条线）
+template <int N, class Rule>
+static bool redo_internal(GomokuGame* g, int plies) {
+    if (plies < 1 || plies > g->historyCount - g->moveCount) {
         return false;
     }
-    for (int i = 0; i < 2; i++) {
-        moveCount_internal--;
-        int r = moveHistory_internal[moveCount_internal][0];
-        int c = moveHistory_internal[moveCount_internal][1];
-        board_internal[r][c] = ' ';
+    for (int i = 0; i < plies; i++) {
+        board_redo_move<N>(g);
     }
-    for (int i = 0; i < GOMOKU_SIZE; i++)
-        for (int j = 0; j < GOMOKU_SIZE; j++)
-            winMarks_internal[i][j] = 0;
+    const MoveDelta* last = &g->deltas[g->moveCount - 1];
+    WinState w;
+    board_find_win<N, Rule>(g, last->player, last->row, last->col, &w);
+    board_show_win<N>(g, w);
     return true;
 }
 
-bool gomoku_save(const char* filename) {
+bool gomoku_game_redo(GomokuGame* g, int plies) {
+    GOMOKU_DISPATCH(g, redo_internal, g, plies);
+}
+
+
+int gomoku_game_redo_count(const GomokuGame* g) {
+    return g->historyCount - g->moveCount;
+}
+
+bool gomoku_game_save(const GomokuGame* g, const char* filename) {
     FILE* fp = fopen(filename, "w");
     if (!fp) return false;
-    if (fprintf(fp, "%d\n", moveCount_internal) < 0) {
+    if (fprintf(fp, "%d\n", g->moveCount) < 0) {
         fclose(fp);
         return false;
     }
-    for (int i = 0; i < moveCount_internal; i++) {
-        int r = moveHistory_internal[i][0];
-        int c = moveHistory_internal[i][1];
+    for (int i = 0; i < g->moveCount; i++) {
+        int r = g->deltas[i].row;
+        int c = g->deltas[i].col;
         if (fprintf(fp, "%d %d\n", r, c) < 0) {
             fclose(fp);
             return false;
@@ -81,194 +231,519 @@ bool gomoku_save(const char* filename) {
     return true;
 }
 
-bool gomoku_load(const char* filename) {
+// 按走子列表重放（第偶数手为 'X'、第奇数手为 'O'），沿用句柄当前的棋盘尺寸与规则；不检查禁手。
+// 遇到越界或已有棋子的格子时停在那里并返回 false
+template <int N, class Rule>
+static bool replay_internal(GomokuGame* g, const int moves[][2], int count) {
+    reset_internal(g, N, g->rule);
+    if (count < 0 || count > N * N) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        int r = moves[i][0], c = moves[i][1];
+        if (!is_valid_move_internal<N>(g, r, c)) {
+            return false;
+        }
+        g->currentPlayer = (i % 2 == 0) ? 'X' : 'O';
+        board_do_move<N, Rule>(g, r, c);
+    }
+    // 胜利标记按最后一手的落子方检查，之后再换成轮走方
+    if (g->moveCount > 0) {
+        const MoveDelta* last = &g->deltas[g->moveCount - 1];
+        mark_win_internal<N, Rule>(g, last->row, last->col);
+    }
+    g->currentPlayer = (g->moveCount % 2 == 0) ? 'X' : 'O';
+    return true;
+}
+
+bool gomoku_game_load_moves(GomokuGame* g, const int moves[][2], int count) {
+    GOMOKU_DISPATCH(g, replay_internal, g, moves, count);
+}
+
+// 文本存档：第一行步数，之后每行一手 "行 列"
+static bool load_from_internal(GomokuGame* g, FILE* fp) {
+    int moves[GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE][2];
+    int cnt = 0;
+    if (fscanf(fp, "%d", &cnt) != 1 || cnt < 0 || cnt > GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE) {
+        gomoku_game_init(g);
+        return false;
+    }
+    int n = 0;
+    while (n < cnt && fscanf(fp, "%d %d", &moves[n][0], &moves[n][1]) == 2) n++;
+    return gomoku_game_load_moves(g, moves, n) && n == cnt;
+}
+
+bool gomoku_game_load(GomokuGame* g, const char* filename) {
     FILE* fp = fopen(filename, "r");
     if (!fp) return false;
-    gomoku_init();
-    int cnt = 0;
-    if (fscanf(fp, "%d", &cnt) != 1) {
-        fclose(fp);
+    bool ok = load_from_internal(g, fp);
+    fclose(fp);
+    return ok;
+}
+
+
+// 二进制存档：14 字节文件头之后每手一个格子编号 r * size + c（15 路 1 字节，19/20 路 2 字节小端）。
+// 文件头：魔数 "GMKB"、版本、尺寸、规则、保留字节、步数（2 字节小端）、校验和（4 字节小端，
+// 对版本到步数的 6 个字节与全部着法做 FNV-1a）
+#define RECORD_MAGIC "GMKB"
+#define RECORD_VERSION 1
+
+static int record_move_bytes_internal(int size) {
+    return size * size <= 256 ? 1 : 2;
+}
+
+static uint32_t record_checksum_internal(const unsigned char* record, int bytes) {
+    uint32_t h = 2166136261u;
+    for (int i = 4; i < bytes; i++) {
+        if (i >= 10 && i < GOMOKU_RECORD_HEADER_BYTES) continue;
+        h = (h ^ record[i]) * 16777619u;
+    }
+    return h;
+}
+
+int gomoku_game_encode(const GomokuGame* g, unsigned char* buffer, int capacity) {
+    int size = gomoku_game_board_size(g);
+    int width = record_move_bytes_internal(size);
+    int bytes = GOMOKU_RECORD_HEADER_BYTES + width * g->moveCount;
+    if (capacity < bytes) return 0;
+    memcpy(buffer, RECORD_MAGIC, 4);
+    buffer[4] = RECORD_VERSION;
+    buffer[5] = (unsigned char)size;
+    buffer[6] = (unsigned char)gomoku_game_rule(g);
+    buffer[7] = 0;
+    buffer[8] = (unsigned char)(g->moveCount & 0xFF);
+    buffer[9] = (unsigned char)(g->moveCount >> 8);
+    unsigned char* p = buffer + GOMOKU_RECORD_HEADER_BYTES;
+    for (int i = 0; i < g->moveCount; i++) {
+        int cell = g->deltas[i].row * size + g->deltas[i].col;
+        *p++ = (unsigned char)(cell & 0xFF);
+        if (width == 2) *p++ = (unsigned char)(cell >> 8);
+    }
+    uint32_t h = record_checksum_internal(buffer, bytes);
+    for (int i = 0; i < 4; i++) buffer[10 + i] = (unsigned char)(h >> (8 * i));
+    return bytes;
+}
+
+bool gomoku_game_decode(GomokuGame* g, const unsigned char* data, int length) {
+    int moves[GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE][2];
+    if (length < GOMOKU_RECORD_HEADER_BYTES || memcmp(data, RECORD_MAGIC, 4) != 0 || data[4] != RECORD_VERSION) {
         return false;
     }
-    if (cnt < 0 || cnt > GOMOKU_SIZE * GOMOKU_SIZE) {
-        fclose(fp);
+    int size = data[5];
+    GomokuRule rule = (GomokuRule)data[6];
+    int count = data[8] | (data[9] << 8);
+    if (!is_supported_size_internal(size) || !is_supported_rule_internal(rule) || count > size * size) {
         return false;
     }
-    for (int i = 0; i < cnt; i++) {
-        int r, c;
-        if (fscanf(fp, "%d %d", &r, &c) != 2) {
-            fclose(fp);
-            return false;
-        }
-        if (r < 0 || r >= GOMOKU_SIZE || c < 0 || c >= GOMOKU_SIZE) {
-            fclose(fp);
-            return false;
-        }
-        board_internal[r][c] = (i % 2 == 0) ? 'X' : 'O';
-        moveHistory_internal[i][0] = r;
-        moveHistory_internal[i][1] = c;
+    int width = record_move_bytes_internal(size);
+    if (length != GOMOKU_RECORD_HEADER_BYTES + width * count) {
+        return false;
     }
-    moveCount_internal = cnt;
-    currentPlayer_internal = (moveCount_internal % 2 == 0) ? 'X' : 'O';
-    if (moveCount_internal > 0) {
-        int lr = moveHistory_internal[moveCount_internal - 1][0];
-        int lc = moveHistory_internal[moveCount_internal - 1][1];
-        gomoku_mark_win(lr, lc);
+    uint32_t h = (uint32_t)data[10] | ((uint32_t)data[11] << 8) | ((uint32_t)data[12] << 16) | ((uint32_t)data[13] << 24);
+    if (h != record_checksum_internal(data, length)) {
+        return false;
+    }
+    // 重放前先查出越界与重复的格子，保证失败时不动 g
+    bool seen[GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE] = {};
+    const unsigned char* p = data + GOMOKU_RECORD_HEADER_BYTES;
+    for (int i = 0; i < count; i++) {
+        int cell = *p++;
+        if (width == 2) cell |= *p++ << 8;
+        if (cell >= size * size || seen[cell]) return false;
+        seen[cell] = true;
+        moves[i][0] = cell / size;
+        moves[i][1] = cell % size;
     }
+    gomoku_game_init_variant(g, size, rule);
+    return gomoku_game_load_moves(g, moves, count);
+}
+
+bool gomoku_game_save_binary(const GomokuGame* g, const char* filename) {
+    unsigned char record[GOMOKU_RECORD_MAX_BYTES];
+    int bytes = gomoku_game_encode(g, record, sizeof(record));
+    FILE* fp = fopen(filename, "wb");
+    if (!fp) return false;
+    bool ok = fwrite(record, 1, bytes, fp) == (size_t)bytes;
+    if (fclose(fp) != 0) ok = false;
+    return ok;
+}
+
+bool gomoku_game_load_binary(GomokuGame* g, const char* filename) {
+    unsigned char record[GOMOKU_RECORD_MAX_BYTES + 1];
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) return false;
+    int bytes = (int)fread(record, 1, sizeof(record), fp);
     fclose(fp);
-    return true;
+    return gomoku_game_decode(g, record, bytes);
 }
 
 
-void gomoku_mark_win(int row, int col) {
-    for (int i = 0; i < GOMOKU_SIZE; i++)
-        for (int j = 0; j < GOMOKU_SIZE; j++)
-            winMarks_internal[i][j] = 0;
-    int dirs[4][2] = { {0,1}, {1,0}, {1,1}, {1,-1} };
-    for (int d = 0; d < 4; d++) {
-        int dr = dirs[d][0], dc = dirs[d][1];
-        int count = 1;
-        int r = row + dr, c = col + dc;
-        while (r >= 0 && r < GOMOKU_SIZE && c >= 0 && c < GOMOKU_SIZE && board_internal[r][c] == currentPlayer_internal) {
-            count++;
-            r += dr; c += dc;
-        }
-        // 反向统计
-        r = row - dr; c = col - dc;
-        while (r >= 0 && r < GOMOKU_SIZE && c >= 0 && c < GOMOKU_SIZE && board_internal[r][c] == currentPlayer_internal) {
-            count++;
-            r -= dr; c -= dc;
-        }
-        if (count >= 5) {
-            winMarks_internal[row][col] = 1;
-            for (int k = 1; k < 5; k++) {
-                int rr = row + dr * k, cc = col + dc * k;
-                if (rr < 0 || rr >= GOMOKU_SIZE || cc < 0 || cc >= GOMOKU_SIZE) break;
-                if (board_internal[rr][cc] == currentPlayer_internal) winMarks_internal[rr][cc] = 1;
-                else break;
-            }
-            for (int k = 1; k < 5; k++) {
-                int rr = row - dr * k, cc = col - dc * k;
-                if (rr < 0 || rr >= GOMOKU_SIZE || cc < 0 || cc >= GOMOKU_SIZE) break;
-                if (board_internal[rr][cc] == currentPlayer_internal) winMarks_internal[rr][cc] = 1;
-                else break;
-            }
+uint64_t gomoku_game_position_hash(const GomokuGame* g) {
+    return g->hash;
+}
+
+
+int gomoku_game_evaluate(const GomokuGame* g) {
+    return board_evaluate(g, board_player_index(g->currentPlayer));
+}
+
+
+template <int N>
+static int candidate_moves_internal(const GomokuGame* g, int radius, int moves[][2], int capacity) {
+    if (capacity <= 0) return 0;
+    if (radius < 1) radius = 1;
+    if (radius > GOMOKU_MAX_CANDIDATE_RADIUS) radius = GOMOKU_MAX_CANDIDATE_RADIUS;
+    if (g->moveCount == 0) {
+        moves[0][0] = N / 2;
+        moves[0][1] = N / 2;
+        return 1;
+    }
+    int n = 0;
+    for (int r = 0; r < N; r++) {
+        uint32_t occupied = (g->lineBits[0][0][r] | g->lineBits[1][0][r]) >> LINE_PAD;
+        for (uint32_t bits = g->nearRows[radius - 1][r] & ~occupied; bits; bits &= bits - 1) {
+            moves[n][0] = r;
+            moves[n][1] = board_lowest_bit(bits);
+            if (++n == capacity) return n;
         }
     }
+    return n;
 }
 
+int gomoku_game_candidate_moves(const GomokuGame* g, int radius, int moves[][2], int capacity) {
+    GOMOKU_DISPATCH_SIZE(g, candidate_moves_internal, g, radius, moves, capacity);
+}
 
-bool gomoku_check_win(int row, int col) {
-    gomoku_mark_win(row, col);
-    for (int i = 0; i < GOMOKU_SIZE; i++) {
-        for (int j = 0; j < GOMOKU_SIZE; j++) {
-            if (winMarks_internal[i][j]) return true;
+
+uint64_t gomoku_hash_moves(const int moves[][2], int count) {
+    uint64_t h = 0;
+    for (int i = 0; i < count; i++) {
+        int r = moves[i][0], c = moves[i][1];
+        if (r < 0 || r >= GOMOKU_MAX_SIZE || c < 0 || c >= GOMOKU_MAX_SIZE) continue;
+        h ^= gomoku_zobrist_keys.key[i % 2][board_cell_index(r, c)];
+    }
+    return h;
+}
+
+
+// 行线就是位棋盘本身、列线就是转置后的位棋盘，直接作为 symmetry_canonical_hash() 的一对位棋盘
+template <int N>
+static uint64_t canonical_hash_internal(const GomokuGame* g, int* symmetry) {
+    SymmetryBoard pair[2];
+    for (int p = 0; p < 2; p++) {
+        for (int i = 0; i < N; i++) {
+            pair[0].rows[p][i] = g->lineBits[p][0][i] >> LINE_PAD;
+            pair[1].rows[p][i] = g->lineBits[p][1][i] >> LINE_PAD;
         }
     }
-    return false;
+    return symmetry_canonical_hash(pair, N, symmetry);
 }
 
+uint64_t gomoku_game_canonical_hash(const GomokuGame* g, int* symmetry) {
+    GOMOKU_DISPATCH_SIZE(g, canonical_hash_internal, g, symmetry);
+}
 
-void gomoku_switch_player(void) {
-    currentPlayer_internal = (currentPlayer_internal == 'X') ? 'O' : 'X';
+void gomoku_symmetry_map(int symmetry, int size, int row, int col, int* outRow, int* outCol) {
+    if (symmetry < 0 || symmetry >= SYMMETRY_COUNT) symmetry = 0;
+    symmetry_apply(symmetry, size, row, col, outRow, outCol);
 }
 
+int gomoku_symmetry_inverse(int symmetry) {
+    return symmetry < 0 || symmetry >= SYMMETRY_COUNT ? 0 : symmetry_inverse(symmetry);
+}
 
-char gomoku_current_player(void) {
-    return currentPlayer_internal;
+
+void gomoku_game_mark_win(GomokuGame* g, int row, int col) {
+    gomoku_game_check_win(g, row, col);
 }
 
 
-void gomoku_detect_threats(void) {
-    for (int i = 0; i < GOMOKU_SIZE; i++)
-        for (int j = 0; j < GOMOKU_SIZE; j++)
-            threatMarks_internal[i][j] = 0;
-    char opponent = (currentPlayer_internal == 'X') ? 'O' : 'X';
-    int dirs[4][2] = { {0,1}, {1,0}, {1,1}, {1,-1} };
-    for (int i = 0; i < GOMOKU_SIZE; i++) {
-        for (int j = 0; j < GOMOKU_SIZE; j++) {
-            if (board_internal[i][j] != ' ') {
-                threatMarks_internal[i][j] = 0;
-                continue;
-            }
-            board_internal[i][j] = opponent;
-            int isThreat = 0;
-            for (int d = 0; d < 4; d++) {
-                int dr = dirs[d][0], dc = dirs[d][1];
-                int lenPos = 0, lenNeg = 0;
-                for (int k = 1; k < 5; k++) {
-                    int r = i + dr * k, c = j + dc * k;
-                    if (r < 0 || r >= GOMOKU_SIZE || c < 0 || c >= GOMOKU_SIZE || board_internal[r][c] != opponent) break;
-                    lenPos++;
-                }
-                for (int k = 1; k < 5; k++) {
-                    int r = i - dr * k, c = j - dc * k;
-                    if (r < 0 || r >= GOMOKU_SIZE || c < 0 || c >= GOMOKU_SIZE || board_internal[r][c] != opponent) break;
-                    lenNeg++;
-                }
-                int count = 1 + lenPos + lenNeg;
-                if (count >= 5) {
-                    isThreat = 1;
-                    break;
-                }
-                else if (count == 4) {
-                    int end1_r = i + dr * (lenPos + 1), end1_c = j + dc * (lenPos + 1);
-                    int end2_r = i - dr * (lenNeg + 1), end2_c = j - dc * (lenNeg + 1);
-                    int open1 = (end1_r >= 0 && end1_r < GOMOKU_SIZE && end1_c >= 0 && end1_c < GOMOKU_SIZE && board_internal[end1_r][end1_c] == ' ');
-                    int open2 = (end2_r >= 0 && end2_r < GOMOKU_SIZE && end2_c >= 0 && end2_c < GOMOKU_SIZE && board_internal[end2_r][end2_c] == ' ');
-                    if (open1 && open2) {
-                        isThreat = 1;
-                        break;
-                    }
-                }
-            }
-            threatMarks_internal[i][j] = isThreat;
-            board_internal[i][j] = ' ';
+bool gomoku_game_check_win(GomokuGame* g, int row, int col) {
+    GOMOKU_DISPATCH(g, mark_win_internal, g, row, col);
+}
+
+
+void gomoku_game_switch_player(GomokuGame* g) {
+    g->currentPlayer = (g->currentPlayer == 'X') ? 'O' : 'X';
+}
+
+
+char gomoku_game_current_player(const GomokuGame* g) {
+    return g->currentPlayer;
+}
+
+
+// 威胁位已在落子/悔棋时增量维护，这里只把对手方的结果与上次展示的行逐行比较，同步变化的格子。
+// 威胁位按自由规则的棋形表得出，展示前逐点按规则核对（标准规则的长连、Caro 两端被堵的五连不算）；
+// 连珠规则下黑方的禁手点不算威胁
+template <int N, class Rule>
+static void detect_threats_internal(GomokuGame* g) {
+    int opp = board_player_index(g->currentPlayer) ^ 1;
+    g->threatChangeCount = 0;
+    for (int r = 0; r < N; r++) {
+        uint32_t cur = g->threatRows[opp][0][r] | g->threatRows[opp][1][r]
+            | g->threatRows[opp][2][r] | g->threatRows[opp][3][r];
+        for (uint32_t bits = cur; bits; bits &= bits - 1) {
+            int c = board_lowest_bit(bits);
+            if (!board_rule_threat<N, Rule>(g, opp, r, c)) cur &= ~(1u << c);
+        }
+        if (Rule::hasForbidden && opp == 0 && cur) cur &= ~renju_forbidden_row<N>(g, r);
+        uint32_t diff = cur ^ g->shownThreatRows[r];
+        g->shownThreatRows[r] = cur;
+        while (diff) {
+            int c = board_lowest_bit(diff);
+            g->threatMarks[r][c] = (cur >> c) & 1u;
+            g->threatChanges[g->threatChangeCount][0] = (unsigned char)r;
+            g->threatChanges[g->threatChangeCount][1] = (unsigned char)c;
+            g->threatChangeCount++;
+            diff &= diff - 1;
         }
     }
 }
 
-const int (*gomoku_get_threat_marks(void))[GOMOKU_SIZE] {
-    return threatMarks_internal;
+void gomoku_game_detect_threats(GomokuGame* g) {
+    GOMOKU_DISPATCH(g, detect_threats_internal, g);
 }
 
-const int (*gomoku_get_win_marks(void))[GOMOKU_SIZE] {
-    return winMarks_internal;
+
+template <int N, class Rule>
+static bool is_forbidden_internal(const GomokuGame* g, int row, int col) {
+    if (!Rule::hasForbidden || g->currentPlayer != 'X') return false;
+    return is_valid_move_internal<N>(g, row, col) && renju_is_forbidden<N>(g, row, col);
 }
 
+bool gomoku_game_is_forbidden(const GomokuGame* g, int row, int col) {
+    GOMOKU_DISPATCH(g, is_forbidden_internal, g, row, col);
+}
 
-int gomoku_move_count(void) {
-    return moveCount_internal;
+
+template <int N, class Rule>
+static int forbidden_moves_internal(const GomokuGame* g, int moves[][2], int capacity) {
+    if (!Rule::hasForbidden || g->currentPlayer != 'X') return 0;
+    int n = 0;
+    for (int r = 0; r < N && n < capacity; r++) {
+        for (uint32_t bits = renju_forbidden_row<N>(g, r); bits && n < capacity; bits &= bits - 1) {
+            moves[n][0] = r;
+            moves[n][1] = board_lowest_bit(bits);
+            n++;
+        }
+    }
+    return n;
+}
+
+int gomoku_game_forbidden_moves(const GomokuGame* g, int moves[][2], int capacity) {
+    GOMOKU_DISPATCH(g, forbidden_moves_internal, g, moves, capacity);
 }
 
 
-void gomoku_get_move(int index, int* row, int* col) {
-    if (index < 0 || index >= moveCount_internal) {
+int gomoku_game_threat_change_count(const GomokuGame* g) {
+    return g->threatChangeCount;
+}
+
+
+void gomoku_game_get_threat_change(const GomokuGame* g, int index, int* row, int* col) {
+    if (index < 0 || index >= g->threatChangeCount) {
         return;
     }
-    if (row) *row = moveHistory_internal[index][0];
-    if (col) *col = moveHistory_internal[index][1];
+    if (row) *row = g->threatChanges[index][0];
+    if (col) *col = g->threatChanges[index][1];
 }
 
+const int (*gomoku_game_get_threat_marks(const GomokuGame* g))[GOMOKU_MAX_SIZE] {
+    return g->threatMarks;
+}
 
-char gomoku_board_cell(int row, int col) {
-    if (row < 0 || row >= GOMOKU_SIZE || col < 0 || col >= GOMOKU_SIZE) return ' ';
-    return board_internal[row][col];
+const int (*gomoku_game_get_win_marks(const GomokuGame* g))[GOMOKU_MAX_SIZE] {
+    return g->winMarks;
 }
 
 
-void gomoku_touch_opponent(void) {
-    touchedFlag_internal = true;
-    touchedPlayer_internal = (currentPlayer_internal == 'X') ? 'O' : 'X';
+int gomoku_game_move_count(const GomokuGame* g) {
+    return g->moveCount;
 }
 
 
-bool gomoku_was_touched(void) {
-    return (touchedFlag_internal && currentPlayer_internal == touchedPlayer_internal);
+void gomoku_game_get_move(const GomokuGame* g, int index, int* row, int* col) {
+    if (index < 0 || index >= g->moveCount) {
+        return;
+    }
+    if (row) *row = g->deltas[index].row;
+    if (col) *col = g->deltas[index].col;
+}
+
+
+char gomoku_game_board_cell(const GomokuGame* g, int row, int col) {
+    int n = gomoku_game_board_size(g);
+    if (row < 0 || row >= n || col < 0 || col >= n) return ' ';
+    if (board_has_stone(g, 0, row, col)) return 'X';
+    if (board_has_stone(g, 1, row, col)) return 'O';
+    return ' ';
+}
+
+
+void gomoku_game_touch_opponent(GomokuGame* g) {
+    g->touchedFlag = true;
+    g->touchedPlayer = (g->currentPlayer == 'X') ? 'O' : 'X';
+}
+
+
+bool gomoku_game_was_touched(const GomokuGame* g) {
+    return (g->touchedFlag && g->currentPlayer == g->touchedPlayer);
+}
+
+
+void gomoku_game_clear_touch(GomokuGame* g) {
+    g->touchedFlag = false;
+    g->touchedPlayer = '\0';
+}
+
+
+// ----------------- 默认实例上的全局接口 -----------------
+
+void gomoku_init(void) {
+    gomoku_game_init(&defaultGame_internal);
+}
+
+bool gomoku_init_sized(int size) {
+    return gomoku_game_init_sized(&defaultGame_internal, size);
+}
+
+bool gomoku_init_variant(int size, GomokuRule rule) {
+    return gomoku_game_init_variant(&defaultGame_internal, size, rule);
+}
+
+GomokuRule gomoku_rule(void) {
+    return gomoku_game_rule(&defaultGame_internal);
+}
+
+bool gomoku_is_forbidden(int row, int col) {
+    return gomoku_game_is_forbidden(&defaultGame_internal, row, col);
 }
 
+int gomoku_forbidden_moves(int moves[][2], int capacity) {
+    return gomoku_game_forbidden_moves(&defaultGame_internal, moves, capacity);
+}
+
+int gomoku_board_size(void) {
+    return gomoku_game_board_size(&defaultGame_internal);
+}
+
+bool gomoku_make_move(int row, int col) {
+    return gomoku_game_make_move(&defaultGame_internal, row, col);
+}
+
+bool gomoku_undo_moves(void) {
+    return gomoku_game_undo_moves(&defaultGame_internal);
+}
+
+bool gomoku_undo(int plies) {
+    return gomoku_game_undo(&defaultGame_internal, plies);
+}
+
+bool gomoku_redo(int plies) {
+    return gomoku_game_redo(&defaultGame_internal, plies);
+}
+
+int gomoku_redo_count(void) {
+    return gomoku_game_redo_count(&defaultGame_internal);
+}
+
+bool gomoku_save(const char* filename) {
+    return gomoku_game_save(&defaultGame_internal, filename);
+}
+
+bool gomoku_load(const char* filename) {
+    return gomoku_game_load(&defaultGame_internal, filename);
+}
+
+bool gomoku_save_binary(const char* filename) {
+    return gomoku_game_save_binary(&defaultGame_internal, filename);
+}
+
+bool gomoku_load_binary(const char* filename) {
+    return gomoku_game_load_binary(&defaultGame_internal, filename);
+}
+
+bool gomoku_check_win(int row, int col) {
+    return gomoku_game_check_win(&defaultGame_internal, row, col);
+}
+
+void gomoku_switch_player(void) {
+    gomoku_game_switch_player(&defaultGame_internal);
+}
+
+char gomoku_current_player(void) {
+    return gomoku_game_current_player(&defaultGame_internal);
+}
+
+void gomoku_detect_threats(void) {
+    gomoku_game_detect_threats(&defaultGame_internal);
+}
+
+int gomoku_threat_change_count(void) {
+    return gomoku_game_threat_change_count(&defaultGame_internal);
+}
+
+void gomoku_get_threat_change(int index, int* row, int* col) {
+    gomoku_game_get_threat_change(&defaultGame_internal, index, row, col);
+}
+
+const int (*gomoku_get_threat_marks(void))[GOMOKU_MAX_SIZE] {
+    return gomoku_game_get_threat_marks(&defaultGame_internal);
+}
+
+uint64_t gomoku_position_hash(void) {
+    return gomoku_game_position_hash(&defaultGame_internal);
+}
+
+uint64_t gomoku_canonical_hash(int* symmetry) {
+    return gomoku_game_canonical_hash(&defaultGame_internal, symmetry);
+}
+
+int gomoku_candidate_moves(int radius, int moves[][2], int capacity) {
+    return gomoku_game_candidate_moves(&defaultGame_internal, radius, moves, capacity);
+}
+
+int gomoku_evaluate(void) {
+    return gomoku_game_evaluate(&defaultGame_internal);
+}
+
+bool gomoku_set_nnue(bool enable) {
+    return gomoku_game_set_nnue(&defaultGame_internal, enable);
+}
+
+bool gomoku_nnue_enabled(void) {
+    return gomoku_game_nnue_enabled(&defaultGame_internal);
+}
+
+void gomoku_mark_win(int row, int col) {
+    gomoku_game_mark_win(&defaultGame_internal, row, col);
+}
+
+const int (*gomoku_get_win_marks(void))[GOMOKU_MAX_SIZE] {
+    return gomoku_game_get_win_marks(&defaultGame_internal);
+}
+
+int gomoku_move_count(void) {
+    return gomoku_game_move_count(&defaultGame_internal);
+}
+
+void gomoku_get_move(int index, int* row, int* col) {
+    gomoku_game_get_move(&defaultGame_internal, index, row, col);
+}
+
+char gomoku_board_cell(int row, int col) {
+    return gomoku_game_board_cell(&defaultGame_internal, row, col);
+}
+
+void gomoku_touch_opponent(void) {
+    gomoku_game_touch_opponent(&defaultGame_internal);
+}
+
+bool gomoku_was_touched(void) {
+    return gomoku_game_was_touched(&defaultGame_internal);
+}
 
 void gomoku_clear_touch(void) {
-    touchedFlag_internal = false;
-    touchedPlayer_internal = '\0';
+    gomoku_game_clear_touch(&defaultGame_internal);
 }
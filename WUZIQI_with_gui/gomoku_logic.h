@@ -3,35 +3,134 @@
 #define GOMOKU_LOGIC_H
 #define _CRT_SECURE_NO_WARNINGS 
 #include <stdbool.h>
+#include <stdint.h>
 
-/// ̳ߴ
+/// Ĭ̳ߴ磨15 ·֧ 19 · Gomocup ʹõ 20 · gomoku_init_sized()
 #define GOMOKU_SIZE 15
 
+/// ֵ֧̳ߴ磻в/ʤ鰴˳ߴ䣬пȹ̶Ϊ GOMOKU_MAX_SIZE
+#define GOMOKU_MAX_SIZE 20
+
+/// бʾѳ壨ʤķֵ
+#define GOMOKU_WIN_SCORE 1000000
+
+/// ѡŷֵ֧뾶
+#define GOMOKU_MAX_CANDIDATE_RADIUS 2
+
+/// ׵ļͷֽһ׵ֽ gomoku_game_encode()
+#define GOMOKU_RECORD_HEADER_BYTES 14
+#define GOMOKU_RECORD_MAX_BYTES (GOMOKU_RECORD_HEADER_BYTES + 2 * GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE)
+
+/// ̵ĶԳƱ任4 ת  Ƿת gomoku_canonical_hash()
+#define GOMOKU_SYMMETRY_COUNT 8
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+	/**
+	 * һľÿж̡ʷв/ʤǵȫ״̬
+	 * ֮ͬ以Ӱ죬ڶ߳зֱʹãͬһܱ߳ͬʱ޸ģ
+	 *  gomoku_xxx() ȫֽӿڶһڲĬϾϣ gomoku_default_game()
+	 */
+	typedef struct GomokuGame GomokuGame;
+
+	/**
+	 * Զ浵־ľ gomoku_journal_open()
+	 */
+	typedef struct GomokuJournal GomokuJournal;
+
+	/**
+	 * ʤ򡣹ڿʱѡ gomoku_init_variant()߼㰴ڱɸԵʵ֡
+	 *   GOMOKU_RULE_FREESTYLE  ɹϼʤĬϣ
+	 *   GOMOKU_RULE_EXACT_FIVE ׼ǡʤ
+	 *   GOMOKU_RULE_CARO       Caro˶ԷӶסʤ̱Ե£
+	 *   GOMOKU_RULE_RENJU      飺ڷ'X'ǡʤġΪ֣׷ϼʤ
+	 */
+	typedef enum GomokuRule {
+		GOMOKU_RULE_FREESTYLE = 0,
+		GOMOKU_RULE_EXACT_FIVE,
+		GOMOKU_RULE_CARO,
+		GOMOKU_RULE_RENJU
+	} GomokuRule;
+
 	/**
 	 * ʼ/Ϸ״̬
 	 * Ӧԭ console е initBoard()
 	 */
 	void gomoku_init(void);
 
+	/**
+	 * ָߴ¿֣size ȡ 1519  20
+	 *  true ʾɹߴ粻֧ʱ falseǰԾֱֲ䡣
+	 * ֮ gomoku_init() һߴ硣̵ѭ߽硢롢߱ȶߴڱػ
+	 * ֻѡʹһʵ֣ȵѭʱߴ硣
+	 */
+	bool gomoku_init_sized(int size);
+
+	/**
+	 * ȡǰ̳ߴ磨1519  20GUI Ӧݴ˼ӴС귶Χ
+	 */
+	int gomoku_board_size(void);
+
+	/**
+	 * ָߴ¿֧֡ʱ falseǰԾֱֲ䡣
+	 * gomoku_init()  gomoku_init_sized() õǰ
+	 */
+	bool gomoku_init_variant(int size, GomokuRule rule);
+
+	/**
+	 * ȡǰ
+	 */
+	GomokuRule gomoku_rule(void);
+
+	/**
+	 * жϵǰ (row,col) ǷΪֵֻ֡ڷ'X'ʱſܷ true
+	 * ڽֵ֡ gomoku_make_move() ᷵ false
+	 * жֻϵλ룬ٵݹ鲹ӵ㱾ǷΪ֣жΪʱ䡣
+	 */
+	bool gomoku_is_forbidden(int row, int col);
+
+	/**
+	 * гǰҵȫֵ㣬˳д movesд capacity дĸ
+	 * ѡ/άֻԺѡȷжɨ̡
+	 */
+	int gomoku_forbidden_moves(int moves[][2], int capacity);
+
 	/**
 	 * ӽӿڡ
-	 * row, col: 0 <= row,col < GOMOKU_SIZE
-	 *  true ʾӳɹøΪڷΧڣfalse ʾǷλá
+	 * row, col: 0 <= row,col < gomoku_board_size()
+	 *  true ʾӳɹøΪڷΧڣfalse ʾǷλãºڷĽֵ㣩
 	 * Ӧԭ console  makeMove() ĺļ¼ܣлҡ
 	 */
 	bool gomoku_make_move(int row, int col);
 
 	/**
-	 * 
-	 *  move_count < 2 򷵻 falseκ޸ģɾ true
-	 * Ӧԭ console  undoMoves() ĹܣڴлңGUI ڵú gomoku_switch_player() л
+	 * ͬ gomoku_undo(2)
+	 *  move_count < 2 򷵻 falseκ޸ģ true
+	 * Ӧԭ console  undoMoves() Ĺܣ߷һָúҪ gomoku_switch_player()
 	 */
 	bool gomoku_undo_moves(void);
 
+	/**
+	 *  plies 1 <= plies <= gomoku_move_count()򷵻 false Ҳκ޸ġ
+	 * ÿһӶ¼һյĲ֣λáӷвλ֡ǰʤ߷
+	 * ʱֻԭӡϣвʤ߷ÿΪʱ䣬̴СͲ޹ء
+	 * Ĳ gomoku_redo() ֱһ gomoku_make_move() ¿֡
+	 */
+	bool gomoku_undo(int plies);
+
+	/**
+	 *  plies 1 <= plies <= gomoku_redo_count()򷵻 false Ҳκ޸ġ
+	 * ״̬߷ʤǣ볷ǰȫһ¡
+	 */
+	bool gomoku_redo(int plies);
+
+	/**
+	 * ȡǰĲ
+	 */
+	int gomoku_redo_count(void);
+
 	/**
 	 * 浱ǰԾֵļ filename
 	 *  true ʾɹfalse ʾ򿪻дʧܡ
@@ -42,12 +141,104 @@ extern "C" {
 	/**
 	 * ļ filename ضԾ֡
 	 *  true ʾɹزָ״̬false ʾʧܻʽ
+	 * 浵ֻ¼ӣǰ̳ߴطţ곬ǰߴΪʽطʱ֡
 	 * Ӧԭ console loadGame()ڲٰʷӡ
 	 */
 	bool gomoku_load(const char* filename);
 
 	/**
-	 *  row,col ΪһӺǷʤ
+	 * ԶƸʽ浱ǰԾ֣汾̳ߴ硢У͵ļͷ֮ÿһӱ
+	 * 15 · 1 ֽڣ19/20 · 2 ֽڣ true ʾɹ
+	 */
+	bool gomoku_save_binary(const char* filename);
+
+	/**
+	 * ȡ gomoku_save_binary() ĶԾ֣ļм¼ĳߴ¿ֲطš
+	 * ļ򲻿汾УͲʱ falseǰԾֱֲ䡣
+	 */
+	bool gomoku_load_binary(const char* filename);
+
+	/**
+	 * ȡǰ 64 λ Zobrist ϣ
+	 * ϣֻϵӾ˳޹أ gomoku_make_move()/gomoku_undo_moves()/gomoku_load() ά
+	 * ȡΪ O(1)ֵķ˫˲ϣ
+	 * ڸ̶λûȥصҪжϡͬһ桱ĳϡ
+	 */
+	uint64_t gomoku_position_hash(void);
+
+	/**
+	 * бϣmoves[i] = {row, col}żΪ 'X'Ϊ 'O' gomoku_load() ͬ
+	 * Ӻ gomoku_position_hash() ֵһ£ڲֵΪ浵ϣ
+	 * ̳ߴ޹أͬһκγߴ¹ϣͬ GOMOKU_MAX_SIZE ᱻԡ
+	 */
+	uint64_t gomoku_hash_moves(const int moves[][2], int count);
+
+	/**
+	 * ȡǰĹ淶ϣתתԳƵ 8 õͬһֵ
+	 * û桢ȥصļʱÿֻһݡ
+	 * 淶ȡ 8 水бȽСһֵ Zobrist ϣѹ淶ΰ̺ gomoku_position_hash() ֵͬ
+	 * 任λϰλûɣλתתתֱȡάλᶯÿε¼㣬ά
+	 * symmetry Ϊ NULLдѵǰɹ淶εı任ţ0 .. GOMOKU_SYMMETRY_COUNT-1
+	 *  gomoku_symmetry_map() ѵǰϵŷ㵽淶ϣ任gomoku_symmetry_inverse()
+	 * 汾Գʱм任õ淶ΣʱȡСһ
+	 */
+	uint64_t gomoku_canonical_hash(int* symmetry);
+
+	/**
+	 *  size ·ϵ (row,col) ԳƱ任 symmetry 㵽 (*outRow,*outCol)
+	 * 任ţ0 ȣ1..3 ˳ʱת 90/180/270 ȣ4 ҷת5 ·ת6 Խ߷ת7 ظԽ߷ת
+	 * ΧıŰȱ任
+	 */
+	void gomoku_symmetry_map(int symmetry, int size, int row, int col, int* outRow, int* outCol);
+
+	/**
+	 * ԳƱ任 symmetry 任1  3 棬任档
+	 */
+	int gomoku_symmetry_inverse(int symmetry);
+
+	/**
+	 * ȡǰľ̬֣ӵǰңgomoku_current_player()ĽǶȼ㣬ʾǰռš
+	 * ȫߣ15 · 572 19 · 1020 20 · 1152 ÿֻһ k ʱƸ÷ k ӵķֵ˫ӵ߼ 0
+	 * ܷ gomoku_make_move()/gomoku_undo_moves() ֻӸԼ 20 £ȡΪ O(1)
+	 * ʱֵС GOMOKU_WIN_SCOREʾ
+	 *  gomoku_set_nnue()ʱûľAI Ҷڵͬ
+	 */
+	int gomoku_evaluate(void);
+
+	/**
+	 * ļNNUEȨأɹ trueļڡʽУͲʱ falseԭ籣ֲ䡣
+	 * Ϊȫһݣֻ CPU  int8/int16 ֧ AVX2 ʱԶʹãҪ GPU ⲿп⡣
+	 * ҪԸ gomoku_game_set_nnue() ŻãǰӦоֹͣá
+	 */
+	bool gomoku_nnue_load(const char* filename);
+
+	/**
+	 * Ƿѳɹ硣
+	 */
+	bool gomoku_nnue_loaded(void);
+
+	/**
+	 * ڵǰԾ/رʱҪڵǰ̳ߴ磬򷵻 false ԭ״
+	 * úһۼ gomoku_make_move()/gomoku_undo_moves() ӡֻ䶯ĸ£
+	 * ʱ̣¿ʱã粻õĳߴʱԶرգ
+	 */
+	bool gomoku_set_nnue(bool enable);
+
+	/**
+	 * ǰԾǷ
+	 */
+	bool gomoku_nnue_enabled(void);
+
+	/**
+	 * ɺѡŷһӵľ루ᡢбȡϴߣ radius Ŀλ˳д moves
+	 * radius ȡ 1  2Χʱضϵ 1..GOMOKU_MAX_CANDIDATE_RADIUSmoves ɵ÷ṩд capacity 
+	 * дĸʱֻԪ
+	 * 뾶/ʱάʱڴ棬ҲɨԶӵĸӡ
+	 */
+	int gomoku_candidate_moves(int radius, int moves[][2], int capacity);
+
+	/**
+	 *  row,col ΪһӺǷ񰴵ǰʤ GomokuRule
 	 *  true ʾʤfalse ʾδʤ
 	 * ͬʱڲʤ飨winMarksԱ GUI  gomoku_get_win_marks() 
 	 * Ӧԭ console  checkWin() ߼
@@ -67,19 +258,35 @@ extern "C" {
 	char gomoku_current_player(void);
 
 	/**
-	 * ⵱ǰµв㣨ڸÿλӻγģ
+	 * ⵱ǰµв㣨ڸÿλӻγ塢Ļͬһϵ˫ģºڷĽֵ⣩
 	 * ڲ¶ά threatMarks
+	 * ɱɵͱgomoku_patterns.hһβ
+	 * вλ gomoku_make_move()/gomoku_undo_moves() ʱֻ䶯㣬
+	 * ѽͬ threatMarks¼η仯ĸӣ gomoku_threat_change_count()
 	 * Ӧԭ console detectThreats()
 	 */
 	void gomoku_detect_threats(void);
 
 	/**
-	 * ȡвָ룬 const int (*)[GOMOKU_SIZE]
+	 * ȡһ gomoku_detect_threats() вǷ仯ʧĸ
+	 * GUI ɾݴֻˢ±仯ĸӡ
+	 */
+	int gomoku_threat_change_count(void);
+
+	/**
+	 * ȡ index (0 <= index < gomoku_threat_change_count()) 仯ӵλãͨ row,col ء
+	 * 仯ֵ gomoku_get_threat_marks() ȡ
+	 *  index Խ磬򲻻޸ *row, *col
+	 */
+	void gomoku_get_threat_change(int index, int* row, int* col);
+
+	/**
+	 * ȡвָ룬 const int (*)[GOMOKU_MAX_SIZE]ֻ 0 <= r,c < gomoku_board_size() ĲЧ
 	 * GUI ڵ gomoku_detect_threats() ʹô˽ӿڶȡԸв:
-	 *   const int (*marks)[GOMOKU_SIZE] = gomoku_get_threat_marks();
+	 *   const int (*marks)[GOMOKU_MAX_SIZE] = gomoku_get_threat_marks();
 	 *   if (marks[r][c]) { ... }
 	 */
-	const int (*gomoku_get_threat_marks(void))[GOMOKU_SIZE];
+	const int (*gomoku_get_threat_marks(void))[GOMOKU_MAX_SIZE];
 
 	/**
 	 *  row,col ΪĵʤߣУ
@@ -90,12 +297,12 @@ extern "C" {
 	void gomoku_mark_win(int row, int col);
 
 	/**
-	 * ȡʤָ룬 const int (*)[GOMOKU_SIZE]
+	 * ȡʤָ룬 const int (*)[GOMOKU_MAX_SIZE]ֻ 0 <= r,c < gomoku_board_size() ĲЧ
 	 * GUI ɸݴ˽ӿڸʤ:
-	 *   const int (*w)[GOMOKU_SIZE] = gomoku_get_win_marks();
+	 *   const int (*w)[GOMOKU_MAX_SIZE] = gomoku_get_win_marks();
 	 *   if (w[r][c]) { ... }
 	 */
-	const int (*gomoku_get_win_marks(void))[GOMOKU_SIZE];
+	const int (*gomoku_get_win_marks(void))[GOMOKU_MAX_SIZE];
 
 	/**
 	 * ȡǰӲʷȣ
@@ -133,6 +340,127 @@ extern "C" {
 	 */
 	void gomoku_clear_touch(void);
 
+
+	// ----------------- ӿ -----------------
+	//  gomoku_game_xxx(g, ...)  gomoku_xxx(...) һһӦֻͬھ g ϡ
+
+	/**
+	 * һ岢ɳʼ൱ѵ gomoku_game_init()
+	 * ڴʧʱ NULL gomoku_game_destroy() ͷš
+	 */
+	GomokuGame* gomoku_game_create(void);
+
+	/**
+	 * ָߴ磨1519  20һ壻ߴ粻ֻ֧ڴʧʱ NULL
+	 * gomoku_game_create() ൱ gomoku_game_create_sized(GOMOKU_SIZE)
+	 */
+	GomokuGame* gomoku_game_create_sized(int size);
+
+	/**
+	 * ָߴ򴴽һ壻ֻ֧ڴʧʱ NULL
+	 */
+	GomokuGame* gomoku_game_create_variant(int size, GomokuRule rule);
+
+	/**
+	 * ͷ gomoku_game_create() ľ NULL ĬϾʱκ¡
+	 */
+	void gomoku_game_destroy(GomokuGame* g);
+
+	/**
+	 * ȡȫֽӿʹõĬϾھɴӿڻá
+	 */
+	GomokuGame* gomoku_default_game(void);
+
+	void gomoku_game_init(GomokuGame* g);
+	bool gomoku_game_init_sized(GomokuGame* g, int size);
+	bool gomoku_game_init_variant(GomokuGame* g, int size, GomokuRule rule);
+	int gomoku_game_board_size(const GomokuGame* g);
+	GomokuRule gomoku_game_rule(const GomokuGame* g);
+	bool gomoku_game_is_forbidden(const GomokuGame* g, int row, int col);
+	int gomoku_game_forbidden_moves(const GomokuGame* g, int moves[][2], int capacity);
+	bool gomoku_game_make_move(GomokuGame* g, int row, int col);
+	bool gomoku_game_undo_moves(GomokuGame* g);
+	bool gomoku_game_undo(GomokuGame* g, int plies);
+	bool gomoku_game_redo(GomokuGame* g, int plies);
+	int gomoku_game_redo_count(const GomokuGame* g);
+	bool gomoku_game_save(const GomokuGame* g, const char* filename);
+	bool gomoku_game_load(GomokuGame* g, const char* filename);
+	bool gomoku_game_save_binary(const GomokuGame* g, const char* filename);
+	bool gomoku_game_load_binary(GomokuGame* g, const char* filename);
+	uint64_t gomoku_game_position_hash(const GomokuGame* g);
+	uint64_t gomoku_game_canonical_hash(const GomokuGame* g, int* symmetry);
+	int gomoku_game_evaluate(const GomokuGame* g);
+	bool gomoku_game_set_nnue(GomokuGame* g, bool enable);
+	bool gomoku_game_nnue_enabled(const GomokuGame* g);
+	int gomoku_game_candidate_moves(const GomokuGame* g, int radius, int moves[][2], int capacity);
+	bool gomoku_game_check_win(GomokuGame* g, int row, int col);
+	void gomoku_game_switch_player(GomokuGame* g);
+	char gomoku_game_current_player(const GomokuGame* g);
+	void gomoku_game_detect_threats(GomokuGame* g);
+	int gomoku_game_threat_change_count(const GomokuGame* g);
+	void gomoku_game_get_threat_change(const GomokuGame* g, int index, int* row, int* col);
+	const int (*gomoku_game_get_threat_marks(const GomokuGame* g))[GOMOKU_MAX_SIZE];
+	void gomoku_game_mark_win(GomokuGame* g, int row, int col);
+	const int (*gomoku_game_get_win_marks(const GomokuGame* g))[GOMOKU_MAX_SIZE];
+	int gomoku_game_move_count(const GomokuGame* g);
+	void gomoku_game_get_move(const GomokuGame* g, int index, int* row, int* col);
+	char gomoku_game_board_cell(const GomokuGame* g, int row, int col);
+	void gomoku_game_touch_opponent(GomokuGame* g);
+	bool gomoku_game_was_touched(const GomokuGame* g);
+	void gomoku_game_clear_touch(GomokuGame* g);
+
+	/**
+	 * бؽ gmoves[i] = {row, col}żΪ 'X'Ϊ 'O' g ĳߴ򣬲֡
+	 * Խӵĸʱͣһ֮ǰ false
+	 */
+	bool gomoku_game_load_moves(GomokuGame* g, const int moves[][2], int count);
+
+	/**
+	 *  g ĶԾֱɶףʽͬ gomoku_game_save_binary()д bufferֽ
+	 * capacity ʱ 0GOMOKU_RECORD_MAX_BYTES κζԾ֡
+	 */
+	int gomoku_game_encode(const GomokuGame* g, unsigned char* buffer, int capacity);
+
+	/**
+	 *  gomoku_game_encode() ĽָԾ֣¼еĳߴ¿֣ʽУͲʱ falseg ֲ䡣
+	 */
+	bool gomoku_game_decode(GomokuGame* g, const unsigned char* data, int length);
+
+
+	// ----------------- Զ浵־ -----------------
+	// ־ֻ׷ӵļÿ£ʱ׷ 2 ֽڣд浵
+	//  gomoku_game_recover() ľ档
+
+	/**
+	 * ½ǣ־ļ filenameд g ĳߴ硢Ӳ̡ʧʱ NULL
+	 * syncEvery > 0 ʱÿ׷ syncEvery ¼һ fsyncϲֵ̿
+	 * syncEvery <= 0 ʱֻ gomoku_journal_sync()/gomoku_journal_close() ʱ̡
+	 * ã¼ϵͳ̱ᶪʧϵʱඪʧδ fsync ļ¼
+	 */
+	GomokuJournal* gomoku_journal_open(const char* filename, const GomokuGame* g, int syncEvery);
+
+	/**
+	 * ־ g ĵǰ棺ϴμ¼ӱȽϣŷΪµŷ׷ӣ
+	 * ûʱдļÿӡ塢ág ĳߴ־ͬдʧʱ false
+	 */
+	bool gomoku_journal_record(GomokuJournal* j, const GomokuGame* g);
+
+	/**
+	 * ׷ӵļ¼ fsync ̡
+	 */
+	bool gomoku_journal_sync(GomokuJournal* j);
+
+	/**
+	 * ̲ر־ļ NULL ʱκ¡
+	 */
+	void gomoku_journal_close(GomokuJournal* j);
+
+	/**
+	 * ־ļָԾ֣־ĳߴ¿֣ط볷
+	 * ĩβдһУ鲻ļ¼ļ򲻿ļͷЧʱ falseg ֲ䡣
+	 */
+	bool gomoku_game_recover(GomokuGame* g, const char* filename);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,520 @@
+#include "gomoku_ai.h"
+#include "gomoku_search.h"
+#include "gomoku_tactics.h"
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+// 蒙特卡洛树搜索（UCT）：与 alpha-beta 引擎并列的另一种引擎。
+// 结点全部来自预先分配的结点池，一个结点的子结点在池中连续存放，展开时用原子加一次分到整块，搜索中不再分配内存。
+// 结点池分成两半：落子后保留下来的子树复制（压缩）到另一半，旧的一半整块作废，树不必每步从头建起。
+// 多线程并行走同一棵树：下行时先给经过的结点记一次访问而不加分（虚拟损失），让其他线程暂时避开这条路；
+// 展开由先把状态从 MCTS_LEAF 换成 MCTS_EXPANDING 的线程独占。
+// 随机走子按威胁快速判断加偏：能成五就成五，对方能成五就堵，能做活四就做，对方有活四点时一半概率去挡，
+// 其余在棋子周围随机挑两个空位，取棋形分高的一个。
+
+#define MCTS_LEAF 0
+#define MCTS_EXPANDING 1
+#define MCTS_EXPANDED 2
+#define MCTS_MAX_CHILDREN 24       // 每个结点按着法分最多展开的子结点数
+#define MCTS_EXPAND_VISITS 2       // 叶结点访问到这么多次才展开，省结点池
+#define MCTS_ROLLOUT_PLIES 60      // 随机走子的步数上限，走完不分胜负按和棋计
+#define MCTS_EXPLORATION 0.7f
+#define MCTS_CHECK_PLAYOUTS 63
+#define MCTS_DRAW 2
+#define MCTS_NONE 0xFFFFFFFFu
+
+struct MctsNode {
+    std::atomic<int> visits;  // 含正在进行中的模拟（虚拟损失）
+    std::atomic<int> score;   // 走入该结点的一方的得分：胜 2、和 1、负 0
+    std::atomic<int> state;
+    uint32_t firstChild;
+    uint16_t childCount;
+    unsigned char row, col;
+    bool terminal;            // 走入该结点的一手已经成五
+};
+
+struct MctsTree {
+    MctsNode* pool[2];        // 两半结点池，active 为当前使用的一半
+    int active;
+    uint32_t capacity;        // 每一半的结点数
+    std::atomic<uint32_t> used;
+    std::atomic<bool> full;
+    uint32_t root;
+    // 根结点对应的对局：尺寸、规则、从开局起的着法与走棋方；与新局面的着法前缀一致时才能复用
+    int size;
+    GomokuRule rule;
+    std::vector<uint16_t> rootMoves;
+    char rootSide;
+};
+
+struct MctsWorker {
+    MctsTree* tree;
+    GomokuGame* game;
+    uint64_t rng;
+    uint64_t playouts;
+};
+
+static inline uint32_t mcts_random(MctsWorker* w) {
+    w->rng ^= w->rng >> 12;
+    w->rng ^= w->rng << 25;
+    w->rng ^= w->rng >> 27;
+    return (uint32_t)((w->rng * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+static inline void mcts_init_node(MctsNode* n, int row, int col, bool terminal) {
+    n->visits.store(0, std::memory_order_relaxed);
+    n->score.store(0, std::memory_order_relaxed);
+    n->state.store(MCTS_LEAF, std::memory_order_relaxed);
+    n->firstChild = 0;
+    n->childCount = 0;
+    n->row = (unsigned char)row;
+    n->col = (unsigned char)col;
+    n->terminal = terminal;
+}
+
+// 展开结点 idx（调用方已把状态换成 MCTS_EXPANDING）：能成五时只有成五一个子结点，
+// 对方能成五时只有堵点，否则取着法分最高的 MCTS_MAX_CHILDREN 手，按分数从高到低存放
+template <int N, class Rule>
+static void mcts_expand(MctsTree* t, GomokuGame* g, uint32_t idx, int side) {
+    MctsNode* pool = t->pool[t->active];
+    MctsNode& node = pool[idx];
+    AiMove moves[AI_MAX_MOVES];
+    bool win = ai_five_points<N, Rule>(g, side, moves, 1) > 0;
+    int n = win ? 1 : ai_five_points<N, Rule>(g, side ^ 1, moves, AI_MAX_MOVES);
+    if (!win && n > 0) n = ai_remove_forbidden<N, Rule>(g, side, moves, n);
+    if (!win && n == 0) n = g->moveCount < N * N ? ai_generate<N, Rule>(g, side, moves) : 0;
+    if (n > MCTS_MAX_CHILDREN) {
+        for (int i = 0; i < MCTS_MAX_CHILDREN; i++) ai_pick_move(moves, i, n);
+        n = MCTS_MAX_CHILDREN;
+    }
+    else {
+        for (int i = 0; i < n; i++) ai_pick_move(moves, i, n);
+    }
+    uint32_t first = t->used.fetch_add((uint32_t)n, std::memory_order_relaxed);
+    if ((uint64_t)first + n > t->capacity) {
+        // 结点池用完：不再展开，之后的模拟都从叶结点直接随机走子
+        t->full.store(true, std::memory_order_relaxed);
+        node.state.store(MCTS_LEAF, std::memory_order_release);
+        return;
+    }
+    for (int i = 0; i < n; i++) mcts_init_node(&pool[first + i], moves[i].row, moves[i].col, win);
+    node.firstChild = first;
+    node.childCount = (uint16_t)n;
+    node.state.store(MCTS_EXPANDED, std::memory_order_release);
+}
+
+// UCT 选子结点：没访问过的子结点按着法分顺序先走；其余取 平均得分 + 探索项 最大的
+static inline uint32_t mcts_select(MctsNode* pool, const MctsNode& parent) {
+    float logN = logf((float)(parent.visits.load(std::memory_order_relaxed) + 1));
+    uint32_t best = parent.firstChild;
+    float bestValue = -1.0f;
+    for (uint32_t i = parent.firstChild; i < parent.firstChild + parent.childCount; i++) {
+        int v = pool[i].visits.load(std::memory_order_relaxed);
+        if (v == 0) return i;
+        float q = (float)pool[i].score.load(std::memory_order_relaxed) / (2.0f * v);
+        float value = q + MCTS_EXPLORATION * sqrtf(logN / v);
+        if (value > bestValue) {
+            bestValue = value;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// 在棋子周围一格内随机取一个空位（黑方避开禁手点），没有空位时返回 false
+template <int N, class Rule>
+static bool mcts_random_near(MctsWorker* w, int side, AiMove* m) {
+    const GomokuGame* g = w->game;
+    uint32_t rows[GOMOKU_MAX_SIZE];
+    int total = 0;
+    for (int r = 0; r < N; r++) {
+        uint32_t occupied = (g->lineBits[0][0][r] | g->lineBits[1][0][r]) >> LINE_PAD;
+        rows[r] = g->nearRows[0][r] & ~occupied;
+        total += board_popcount(rows[r]);
+    }
+    if (total == 0) {
+        if (g->moveCount > 0) return false;
+        m->row = m->col = (unsigned char)(N / 2);
+        return true;
+    }
+    for (int tries = 0; tries < 8; tries++) {
+        int k = (int)(mcts_random(w) % (uint32_t)total);
+        int r = 0;
+        while (k >= board_popcount(rows[r])) k -= board_popcount(rows[r++]);
+        uint32_t bits = rows[r];
+        while (k--) bits &= bits - 1;
+        int c = board_lowest_bit(bits);
+        if (Rule::hasForbidden && side == 0 && renju_is_forbidden<N>(g, r, c)) continue;
+        m->row = (unsigned char)r;
+        m->col = (unsigned char)c;
+        return true;
+    }
+    return false;
+}
+
+// 玩家 p 的威胁位（落子后成活四或同线双四）中第一个可走的点
+template <int N, class Rule>
+static bool mcts_threat_point(const GomokuGame* g, int p, int side, AiMove* m) {
+    for (int r = 0; r < N; r++) {
+        uint32_t occupied = (g->lineBits[0][0][r] | g->lineBits[1][0][r]) >> LINE_PAD;
+        uint32_t bits = (g->threatRows[p][0][r] | g->threatRows[p][1][r] | g->threatRows[p][2][r] | g->threatRows[p][3][r]) & ~occupied;
+        for (; bits; bits &= bits - 1) {
+            int c = board_lowest_bit(bits);
+            if (Rule::hasForbidden && side == 0 && renju_is_forbidden<N>(g, r, c)) continue;
+            m->row = (unsigned char)r;
+            m->col = (unsigned char)c;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 从当前局面随机走到终局或步数上限，走完全部撤销；返回胜方下标，和棋为 MCTS_DRAW
+template <int N, class Rule>
+static int mcts_rollout(MctsWorker* w, int side) {
+    GomokuGame* g = w->game;
+    AiMove moves[8];
+    int plies = 0, winner = MCTS_DRAW;
+    while (plies < MCTS_ROLLOUT_PLIES && g->moveCount < N * N) {
+        AiMove m;
+        if (ai_five_points<N, Rule>(g, side, moves, 1)) {
+            winner = side;
+            break;
+        }
+        int n = ai_five_points<N, Rule>(g, side ^ 1, moves, 8);
+        if (n > 0) {
+            n = ai_remove_forbidden<N, Rule>(g, side, moves, n);
+            if (n == 0) {
+                winner = side ^ 1;
+                break;
+            }
+            m = moves[mcts_random(w) % (uint32_t)n];
+        }
+        else if (!mcts_threat_point<N, Rule>(g, side, side, &m)
+            && !((mcts_random(w) & 1) && mcts_threat_point<N, Rule>(g, side ^ 1, side, &m))) {
+            AiMove a, b;
+            if (!mcts_random_near<N, Rule>(w, side, &a)) break;
+            m = a;
+            if (mcts_random_near<N, Rule>(w, side, &b)
+                && ai_cell_score<N>(g, side, b.row, b.col) > ai_cell_score<N>(g, side, a.row, a.col)) {
+                m = b;
+            }
+        }
+        ai_play<N, Rule>(g, m);
+        plies++;
+        side ^= 1;
+    }
+    while (plies--) board_undo_move<N>(g);
+    return winner;
+}
+
+// 一次模拟：从根按 UCT 走到叶结点（够次数就展开），随机走子，再把结果加回路径上的每个结点
+template <int N, class Rule>
+static void mcts_playout(MctsWorker* w) {
+    MctsTree* t = w->tree;
+    GomokuGame* g = w->game;
+    MctsNode* pool = t->pool[t->active];
+    uint32_t path[AI_MAX_MOVES + 1];
+    unsigned char movers[AI_MAX_MOVES + 1];
+    int side = board_player_index(g->currentPlayer);
+    int depth = 0, winner = -1;
+    uint32_t idx = t->root;
+    path[0] = idx;
+    movers[0] = (unsigned char)(side ^ 1);
+    pool[idx].visits.fetch_add(1, std::memory_order_relaxed);
+    for (;;) {
+        MctsNode& node = pool[idx];
+        if (node.terminal) {
+            winner = movers[depth];
+            break;
+        }
+        int state = node.state.load(std::memory_order_acquire);
+        if (state == MCTS_LEAF && !t->full.load(std::memory_order_relaxed)
+            && (depth == 0 || node.visits.load(std::memory_order_relaxed) >= MCTS_EXPAND_VISITS)) {
+            int expected = MCTS_LEAF;
+            if (node.state.compare_exchange_strong(expected, MCTS_EXPANDING, std::memory_order_acquire)) {
+                mcts_expand<N, Rule>(t, g, idx, side);
+                state = node.state.load(std::memory_order_acquire);
+            }
+        }
+        if (state != MCTS_EXPANDED || node.childCount == 0) break;
+        idx = mcts_select(pool, node);
+        pool[idx].visits.fetch_add(1, std::memory_order_relaxed);
+        AiMove m = { 0, pool[idx].row, pool[idx].col };
+        ai_play<N, Rule>(g, m);
+        path[++depth] = idx;
+        movers[depth] = (unsigned char)side;
+        side ^= 1;
+    }
+    if (winner < 0) winner = mcts_rollout<N, Rule>(w, side);
+    for (int i = 0; i <= depth; i++) {
+        int s = winner == MCTS_DRAW ? 1 : (winner == movers[i] ? 2 : 0);
+        pool[path[i]].score.fetch_add(s, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < depth; i++) board_undo_move<N>(g);
+    w->playouts++;
+}
+
+// 把以 from 为根的子树按层复制到另一半结点池，子结点块保持连续；返回复制的结点数
+static uint32_t mcts_compact(MctsTree* t, uint32_t from) {
+    MctsNode* src = t->pool[t->active];
+    MctsNode* dst = t->pool[t->active ^ 1];
+    std::vector<uint32_t> queue;
+    queue.push_back(from);
+    uint32_t used = 1;
+    const MctsNode& r = src[from];
+    mcts_init_node(&dst[0], r.row, r.col, r.terminal);
+    dst[0].visits.store(r.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    dst[0].score.store(r.score.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    for (size_t head = 0; head < queue.size(); head++) {
+        const MctsNode& s = src[queue[head]];
+        MctsNode& d = dst[head];
+        if (s.state.load(std::memory_order_relaxed) != MCTS_EXPANDED) continue;
+        d.firstChild = used;
+        d.childCount = s.childCount;
+        d.state.store(MCTS_EXPANDED, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < s.childCount; i++) {
+            const MctsNode& c = src[s.firstChild + i];
+            MctsNode& e = dst[used + i];
+            mcts_init_node(&e, c.row, c.col, c.terminal);
+            e.visits.store(c.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            e.score.store(c.score.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            queue.push_back(s.firstChild + i);
+        }
+        used += s.childCount;
+    }
+    t->active ^= 1;
+    t->root = 0;
+    t->used = used;
+    t->full = false;
+    return used;
+}
+
+// 全局树与结点池，第一次搜索时按默认大小分配；互斥锁保证同一时刻只有一次搜索在用这棵树
+static MctsTree tree_internal;
+static std::mutex treeMutex_internal;
+
+static void mcts_free(MctsTree* t) {
+    delete[] t->pool[0];
+    delete[] t->pool[1];
+    t->pool[0] = t->pool[1] = NULL;
+    t->capacity = 0;
+    t->rootMoves.clear();
+}
+
+static bool mcts_alloc(MctsTree* t, int megabytes) {
+    uint64_t count = (uint64_t)megabytes * 1024 * 1024 / 2 / sizeof(MctsNode);
+    if (count < 1024) return false;
+    if (count > 0x7FFFFFFFull) count = 0x7FFFFFFFull;
+    MctsNode* a = new (std::nothrow) MctsNode[count];
+    MctsNode* b = a ? new (std::nothrow) MctsNode[count] : NULL;
+    if (!b) {
+        delete[] a;
+        return false;
+    }
+    mcts_free(t);
+    t->pool[0] = a;
+    t->pool[1] = b;
+    t->capacity = (uint32_t)count;
+    t->active = 0;
+    return true;
+}
+
+// 让树的根对准局面 g：g 的着法以旧根的着法开头时沿新着法往下找，找到就把那棵子树压缩过来；
+// 否则清空整棵树，只放一个根结点。返回保留下来的结点数
+static uint32_t mcts_set_root(MctsTree* t, const GomokuGame* g) {
+    std::vector<uint16_t> moves(g->moveCount);
+    for (int i = 0; i < g->moveCount; i++) moves[i] = (uint16_t)(g->deltas[i].row * GOMOKU_MAX_SIZE + g->deltas[i].col);
+    uint32_t node = MCTS_NONE;
+    if (t->used > 0 && t->size == g->size && t->rule == g->rule
+        && t->rootMoves.size() <= moves.size()
+        && std::equal(t->rootMoves.begin(), t->rootMoves.end(), moves.begin())
+        && (((moves.size() - t->rootMoves.size()) & 1) ? t->rootSide != g->currentPlayer : t->rootSide == g->currentPlayer)) {
+        MctsNode* pool = t->pool[t->active];
+        node = t->root;
+        for (size_t i = t->rootMoves.size(); i < moves.size() && node != MCTS_NONE; i++) {
+            const MctsNode& n = pool[node];
+            uint32_t next = MCTS_NONE;
+            if (n.state.load(std::memory_order_relaxed) == MCTS_EXPANDED) {
+                for (uint32_t k = n.firstChild; k < n.firstChild + n.childCount; k++) {
+                    if (pool[k].row * GOMOKU_MAX_SIZE + pool[k].col == moves[i]) next = k;
+                }
+            }
+            node = next;
+        }
+    }
+    t->size = g->size;
+    t->rule = g->rule;
+    t->rootMoves.swap(moves);
+    t->rootSide = g->currentPlayer;
+    if (node != MCTS_NONE) return mcts_compact(t, node);
+    mcts_init_node(&t->pool[t->active][0], 0, 0, false);
+    t->root = 0;
+    t->used = 1;
+    t->full = false;
+    return 0;
+}
+
+// 根结点下访问次数最多的子结点，没有子结点时返回 MCTS_NONE
+static uint32_t mcts_best_child(const MctsNode* nodes, const MctsNode& parent) {
+    if (parent.state.load(std::memory_order_acquire) != MCTS_EXPANDED || parent.childCount == 0) return MCTS_NONE;
+    uint32_t best = parent.firstChild;
+    for (uint32_t i = parent.firstChild; i < parent.firstChild + parent.childCount; i++) {
+        if (nodes[i].visits.load(std::memory_order_relaxed) > nodes[best].visits.load(std::memory_order_relaxed)) best = i;
+    }
+    return best;
+}
+
+// 进度：最佳着法、沿访问次数最多的子结点走出的主变例、最佳着法的胜率（千分数）；搜索进行中也可调用
+static void mcts_fill_progress(const MctsTree* t, GomokuSearchProgress* p) {
+    const MctsNode* nodes = t->pool[t->active];
+    uint32_t best = mcts_best_child(nodes, nodes[t->root]);
+    p->pvLength = 0;
+    p->row = p->col = -1;
+    p->score = 0;
+    if (best == MCTS_NONE) return;
+    p->row = nodes[best].row;
+    p->col = nodes[best].col;
+    int v = nodes[best].visits.load(std::memory_order_relaxed);
+    p->score = v ? (int)(nodes[best].score.load(std::memory_order_relaxed) * 500LL / v) : 0;
+    for (uint32_t i = best; i != MCTS_NONE && p->pvLength < GOMOKU_SEARCH_MAX_PV; i = mcts_best_child(nodes, nodes[i])) {
+        p->pv[p->pvLength][0] = nodes[i].row;
+        p->pv[p->pvLength][1] = nodes[i].col;
+        p->pvLength++;
+        if (nodes[i].terminal || nodes[i].visits.load(std::memory_order_relaxed) < MCTS_EXPAND_VISITS) break;
+    }
+    p->depth = p->pvLength;
+}
+
+// 每次模拟前从控制块领一个名额，超出节点预算就退回并停止；主线程还检查时间、按间隔汇报进度
+template <int N, class Rule>
+static void mcts_worker(MctsWorker* w, SearchControl* c, bool main) {
+    while (!c->stop.load(std::memory_order_relaxed)) {
+        uint64_t total = c->nodes.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (c->maxNodes && total > c->maxNodes) {
+            c->nodes.fetch_sub(1, std::memory_order_relaxed);
+            c->stop.store(true, std::memory_order_relaxed);
+            break;
+        }
+        mcts_playout<N, Rule>(w);
+        if (main && (w->playouts & MCTS_CHECK_PLAYOUTS) == 0) {
+            if (search_check_time(c)) break;
+            if (search_report_due(c)) {
+                GomokuSearchProgress p = {};
+                mcts_fill_progress(w->tree, &p);
+                search_publish(c, &p);
+            }
+        }
+    }
+}
+
+template <int N, class Rule>
+static bool mcts_run_internal(const GomokuGame* src, SearchControl* control, int* row, int* col, GomokuMctsStats* stats) {
+    std::lock_guard<std::mutex> lock(treeMutex_internal);
+    MctsTree* t = &tree_internal;
+    if (!t->pool[0] && !mcts_alloc(t, GOMOKU_MCTS_DEFAULT_MB)) return false;
+    uint32_t reused = mcts_set_root(t, src);
+    int reusedVisits = t->pool[t->active][t->root].visits.load();
+
+    int threads = gomoku_ai_threads();
+    std::vector<MctsWorker> workers(threads);
+    std::vector<std::thread> pool;
+    int created = 0;
+    for (int i = 0; i < threads; i++) {
+        workers[i].tree = t;
+        workers[i].game = gomoku_game_create_variant(src->size, src->rule);
+        if (!workers[i].game) break;
+        memcpy(workers[i].game, src, sizeof(GomokuGame));
+        workers[i].rng = (src->hash ^ 0x9E3779B97F4A7C15ull * (uint64_t)(i + 1)) | 1;
+        workers[i].playouts = 0;
+        created++;
+    }
+    if (created == 0) return false;
+    for (int i = 1; i < created; i++) pool.emplace_back(mcts_worker<N, Rule>, &workers[i], control, false);
+    mcts_worker<N, Rule>(&workers[0], control, true);
+    control->stop = true;
+    for (size_t i = 0; i < pool.size(); i++) pool[i].join();
+    uint64_t playouts = 0;
+    for (int i = 0; i < created; i++) {
+        playouts += workers[i].playouts;
+        gomoku_game_destroy(workers[i].game);
+    }
+
+    GomokuSearchProgress report = {};
+    mcts_fill_progress(t, &report);
+    report.done = true;
+    search_publish(control, &report);
+    bool found = report.row >= 0;
+    if (found) {
+        *row = report.row;
+        *col = report.col;
+    }
+    if (stats) {
+        const MctsNode& root = t->pool[t->active][t->root];
+        int ms = report.timeMs;
+        stats->playouts = playouts;
+        stats->rootVisits = (uint64_t)root.visits.load();
+        stats->reusedVisits = (uint64_t)reusedVisits;
+        stats->nodes = t->used < t->capacity ? t->used.load() : t->capacity;
+        stats->reusedNodes = reused;
+        stats->timeMs = ms;
+        stats->playoutsPerSecond = playouts * 1000 / (uint64_t)(ms > 0 ? ms : 1);
+        stats->threads = created;
+        stats->winRate = found ? report.score / 1000.0 : 0.0;
+        stats->bookMove = false;
+    }
+    return found;
+}
+
+bool mcts_search_run(const GomokuGame* g, SearchControl* control, int* row, int* col, GomokuMctsStats* stats) {
+    double score;
+    if (book_search_move(g, control, row, col, &score)) {
+        if (stats) {
+            memset(stats, 0, sizeof(*stats));
+            stats->threads = 1;
+            stats->winRate = score;
+            stats->bookMove = true;
+        }
+        return true;
+    }
+    GOMOKU_DISPATCH(g, mcts_run_internal, g, control, row, col, stats);
+}
+
+bool gomoku_mcts_set_memory(int megabytes) {
+    std::lock_guard<std::mutex> lock(treeMutex_internal);
+    return mcts_alloc(&tree_internal, megabytes);
+}
+
+void gomoku_mcts_clear(void) {
+    std::lock_guard<std::mutex> lock(treeMutex_internal);
+    tree_internal.rootMoves.clear();
+    tree_internal.used = 0;
+}
+
+bool gomoku_game_mcts_best_move(const GomokuGame* g, int playouts_or_time, int* row, int* col, GomokuMctsStats* stats) {
+    GomokuSearchLimits limits = {};
+    limits.engine = GOMOKU_ENGINE_MCTS;
+    limits.timeMs = playouts_or_time < 0 ? -playouts_or_time : (playouts_or_time == 0 ? GOMOKU_AI_DEFAULT_TIME_MS : 0);
+    limits.maxNodes = playouts_or_time > 0 ? (uint64_t)playouts_or_time : 0;
+    SearchControl control;
+    search_control_init(&control, &limits, NULL, NULL);
+    return mcts_search_run(g, &control, row, col, stats);
+}
+
+
+// ----------------- 默认实例上的全局接口 -----------------
+
+static GomokuMctsStats lastStats_internal;
+
+bool gomoku_mcts_best_move(int playouts_or_time, int* row, int* col) {
+    return gomoku_game_mcts_best_move(gomoku_default_game(), playouts_or_time, row, col, &lastStats_internal);
+}
+
+void gomoku_mcts_last_stats(GomokuMctsStats* stats) {
+    *stats = lastStats_internal;
+}
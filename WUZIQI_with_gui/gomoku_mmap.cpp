@@ -0,0 +1,115 @@
+#include "gomoku_mmap.h"
+#include <stdio.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool mapped_file_open(MappedFile* m, const char* filename) {
+    m->data = NULL;
+    m->size = 0;
+#ifdef _WIN32
+    m->file = NULL;
+    m->mapping = NULL;
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* p = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!p) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m->file = file;
+    m->mapping = mapping;
+    m->data = (const unsigned char*)p;
+    m->size = (size_t)size.QuadPart;
+    return true;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return true;
+    }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+    // 查询多为二分查找，随机访问，不需要预读
+    madvise(p, (size_t)st.st_size, MADV_RANDOM);
+    m->data = (const unsigned char*)p;
+    m->size = (size_t)st.st_size;
+    return true;
+#endif
+}
+
+void mapped_file_close(MappedFile* m) {
+#ifdef _WIN32
+    if (m->data) UnmapViewOfFile(m->data);
+    if (m->mapping) CloseHandle(m->mapping);
+    if (m->file) CloseHandle(m->file);
+    m->file = NULL;
+    m->mapping = NULL;
+#else
+    if (m->data) munmap((void*)m->data, m->size);
+#endif
+    m->data = NULL;
+    m->size = 0;
+}
+
+bool mapped_file_replace(const char* from, const char* to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+bool file_sync(FILE* fp) {
+    if (fflush(fp) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(fp)) == 0;
+#else
+    return fsync(fileno(fp)) == 0;
+#endif
+}
+
+bool file_seek(FILE* fp, uint64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(fp, (__int64)offset, SEEK_SET) == 0;
+#else
+    return fseeko(fp, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+uint64_t file_size(const char* filename) {
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA a;
+    if (!GetFileAttributesExA(filename, GetFileExInfoStandard, &a)) return 0;
+    return ((uint64_t)a.nFileSizeHigh << 32) | a.nFileSizeLow;
+#else
+    struct stat st;
+    if (stat(filename, &st) != 0) return 0;
+    return (uint64_t)st.st_size;
+#endif
+}
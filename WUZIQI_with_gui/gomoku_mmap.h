@@ -0,0 +1,34 @@
+#pragma once
+#ifndef GOMOKU_MMAP_H
+#define GOMOKU_MMAP_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// 只读内存映射文件与几个文件操作（数据库、开局库、自动存档日志等内部使用）。映射后按需由操作系统换页，不把整个文件读进内存；
+// 空文件或打开失败时 data 为 NULL、size 为 0。
+struct MappedFile {
+    const unsigned char* data;
+    size_t size;
+#ifdef _WIN32
+    void* file;
+    void* mapping;
+#endif
+};
+
+bool mapped_file_open(MappedFile* m, const char* filename);
+void mapped_file_close(MappedFile* m);
+
+// 把 fp 的缓冲写出并 fsync 到磁盘
+bool file_sync(FILE* fp);
+
+// 按 64 位偏移定位（大于 2GB 的文件）
+bool file_seek(FILE* fp, uint64_t offset);
+
+// 文件字节数；打不开时返回 0
+uint64_t file_size(const char* filename);
+
+// 把 from 改名为 to，to 已存在时覆盖（用于先写临时文件再整体替换）
+bool mapped_file_replace(const char* from, const char* to);
+
+#endif // GOMOKU_MMAP_H
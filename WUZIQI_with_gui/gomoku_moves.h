@@ -0,0 +1,193 @@
+#pragma once
+#ifndef GOMOKU_MOVES_H
+#define GOMOKU_MOVES_H
+#include "gomoku_rules.h"
+#include <string.h>
+
+// 走子、撤销、重做的核心原语（逻辑层内部使用，搜索也直接调用）。
+// 每一手在 g->deltas 中留下一条 MoveDelta：威胁位与禁手候选位以异或差分保存，同一份差分既能撤销也能重做；
+// 棋子、哈希、评估、邻域由 board_place_stone/board_remove_stone 按经过该格的固定几条线更新。
+// 因此撤销、重做每一手都是常数时间，不复制也不重新扫描棋盘。
+// 胜利标记不在这里维护：board_do_move 只记下落子前的 WinState，由调用方决定是否显示。
+
+// 落子后成五、活四或同线双冲四的空位算作威胁点。威胁位按自由规则的棋形表增量维护，是各规则下威胁点的超集
+// （其余规则的成五都是自由规则成五的一部分）；要按规则的确切结果时用 board_rule_threat 逐点核对
+#define THREAT_SHAPE SHAPE_DOUBLE_FOUR
+
+// 线上放好 p 方棋子 stones（对方为 opp）后，再在空位 f 落子是否按规则成五，且这个五连经过第 b 位
+template <class Rule>
+static inline bool board_line_five(uint32_t stones, uint32_t opp, int p, int f, int b) {
+    uint32_t run = board_run_through(stones | (1u << f), f);
+    int len = board_popcount(run);
+    if (len < 5 || !((run >> b) & 1u)) return false;
+    uint32_t ends = ((run << 1) | (run >> 1)) & ~run;
+    return Rule::fiveWins(p, len, (ends & opp) == ends);
+}
+
+// 玩家 p 在空位 (r,c) 落子后，是否在某条线上按规则成五，或在同一条线上留下两个按规则成五、且五连经过 (r,c) 的空位
+// （活四、同线双冲四）。成五点按 Rule::fiveWins 判断，因此标准规则的长连、Caro 两端被堵的五连都不算
+template <int N, class Rule>
+static inline bool board_rule_threat(const GomokuGame* g, int p, int r, int c) {
+    for (int d = 0; d < LINE_DIRS; d++) {
+        int idx = board_line_index<N>(d, r, c);
+        int b = board_line_pos(d, r, c);
+        uint32_t x = g->lineBits[p][d][idx] | (1u << b);
+        uint32_t o = g->lineBits[p ^ 1][d][idx];
+        if (board_line_five<Rule>(x, o, p, b, b)) return true;
+        int fives = 0;
+        uint32_t empty = (0x1FFu << (b - PATTERN_WINDOW)) & board_line_mask<N>(d, idx) & ~(x | o);
+        for (; empty; empty &= empty - 1) {
+            if (board_line_five<Rule>(x, o, p, board_lowest_bit(empty), b) && ++fives == 2) return true;
+        }
+    }
+    return false;
+}
+
+// 把一条线上某个位集的变化 diff 翻转到按行投影的 rows 上
+template <int N>
+static inline void board_project_rows(uint32_t rows[GOMOKU_MAX_SIZE], int d, int idx, uint32_t diff) {
+    while (diff) {
+        int rr, cc;
+        board_line_cell<N>(d, idx, board_lowest_bit(diff), &rr, &cc);
+        rows[rr] ^= 1u << cc;
+        diff &= diff - 1;
+    }
+}
+
+// (r,c) 的落子或提子只会改变经过它的四条线上、距它 4 格以内空位的棋形；
+// 对这些空位查表重算双方威胁位（连珠规则下还有黑方禁手候选），把差异投影到行并记入 m
+template <int N, class Rule>
+static inline void board_update_threats(GomokuGame* g, int r, int c, MoveDelta* m) {
+    for (int d = 0; d < LINE_DIRS; d++) {
+        int idx = board_line_index<N>(d, r, c);
+        int b = board_line_pos(d, r, c);
+        uint32_t mask = board_line_mask<N>(d, idx);
+        uint32_t x = g->lineBits[0][d][idx];
+        uint32_t o = g->lineBits[1][d][idx];
+        uint32_t near = (0x1FFu << (b - PATTERN_WINDOW)) & mask;
+        uint32_t t[2] = { g->lineThreats[0][d][idx] & ~near, g->lineThreats[1][d][idx] & ~near };
+        uint32_t f[2] = { g->renjuLines[0][d][idx] & ~near, g->renjuLines[1][d][idx] & ~near };
+        for (uint32_t e = near & ~(x | o); e; e &= e - 1) {
+            int q = board_lowest_bit(e);
+            uint8_t entry = pattern_lookup(x, o, ~mask, q);
+            int shape = pattern_shape(entry, 0);
+            if (shape >= THREAT_SHAPE) t[0] |= 1u << q;
+            if (pattern_shape(entry, 1) >= THREAT_SHAPE) t[1] |= 1u << q;
+            if (Rule::hasForbidden) {
+                if (shape >= SHAPE_SPLIT_THREE) f[0] |= 1u << q;
+                if (shape == SHAPE_DOUBLE_FOUR || shape == SHAPE_FIVE) f[1] |= 1u << q;
+            }
+        }
+        for (int p = 0; p < 2; p++) {
+            uint32_t diff = t[p] ^ g->lineThreats[p][d][idx];
+            g->lineThreats[p][d][idx] = t[p];
+            m->threatFlip[p][d] = diff;
+            board_project_rows<N>(g->threatRows[p][d], d, idx, diff);
+            if (Rule::hasForbidden) {
+                diff = f[p] ^ g->renjuLines[p][d][idx];
+                g->renjuLines[p][d][idx] = f[p];
+                m->renjuFlip[p][d] = diff;
+                board_project_rows<N>(g->renjuRows[p][d], d, idx, diff);
+            }
+        }
+    }
+}
+
+// 把 m 中记录的威胁差分再翻转一次：撤销与重做共用
+template <int N>
+static inline void board_apply_threat_flip(GomokuGame* g, const MoveDelta* m) {
+    for (int d = 0; d < LINE_DIRS; d++) {
+        int idx = board_line_index<N>(d, m->row, m->col);
+        for (int p = 0; p < 2; p++) {
+            if (m->threatFlip[p][d]) {
+                g->lineThreats[p][d][idx] ^= m->threatFlip[p][d];
+                board_project_rows<N>(g->threatRows[p][d], d, idx, m->threatFlip[p][d]);
+            }
+            if (m->renjuFlip[p][d]) {
+                g->renjuLines[p][d][idx] ^= m->renjuFlip[p][d];
+                board_project_rows<N>(g->renjuRows[p][d], d, idx, m->renjuFlip[p][d]);
+            }
+        }
+    }
+}
+
+// 当前玩家在空位 (r,c) 落子并记录差分；不检查合法性与禁手，不切换玩家。清空可重做的部分
+template <int N, class Rule>
+static inline void board_do_move(GomokuGame* g, int r, int c) {
+    MoveDelta* m = &g->deltas[g->moveCount];
+    int p = board_player_index(g->currentPlayer);
+    m->row = (unsigned char)r;
+    m->col = (unsigned char)c;
+    m->player = (unsigned char)p;
+    m->sideBefore = g->currentPlayer;
+    m->sideAfter = g->currentPlayer;
+    m->winBefore = g->win;
+    if (!Rule::hasForbidden) memset(m->renjuFlip, 0, sizeof(m->renjuFlip));
+    board_place_stone<N>(g, p, r, c);
+    board_update_threats<N, Rule>(g, r, c, m);
+    g->moveCount++;
+    g->historyCount = g->moveCount;
+}
+
+// 撤销最近一手（调用方保证 moveCount > 0），恢复落子前的轮走方；此刻的轮走方留给重做
+template <int N>
+static inline void board_undo_move(GomokuGame* g) {
+    MoveDelta* m = &g->deltas[--g->moveCount];
+    m->sideAfter = g->currentPlayer;
+    board_remove_stone<N>(g, m->player, m->row, m->col);
+    board_apply_threat_flip<N>(g, m);
+    g->currentPlayer = m->sideBefore;
+}
+
+// 重做下一手（调用方保证 moveCount < historyCount），恢复撤销时的轮走方
+template <int N>
+static inline void board_redo_move(GomokuGame* g) {
+    const MoveDelta* m = &g->deltas[g->moveCount++];
+    board_place_stone<N>(g, m->player, m->row, m->col);
+    board_apply_threat_flip<N>(g, m);
+    g->currentPlayer = m->sideAfter;
+}
+
+// 在 (row,col) 所在的四条线上找玩家 p 的五连并按规则判定胜负，把获胜的整段连子记入 w
+template <int N, class Rule>
+static inline bool board_find_win(const GomokuGame* g, int p, int row, int col, WinState* w) {
+    memset(w, 0, sizeof(*w));
+    w->row = (unsigned char)row;
+    w->col = (unsigned char)col;
+    bool won = false;
+    for (int d = 0; d < LINE_DIRS; d++) {
+        int idx = board_line_index<N>(d, row, col);
+        int b = board_line_pos(d, row, col);
+        uint32_t x = g->lineBits[p][d][idx];
+        uint32_t f = board_five_starts(x);
+        uint32_t spread = f | (f << 1) | (f << 2) | (f << 3) | (f << 4);
+        if (!((spread >> b) & 1u)) continue;
+        uint32_t run = board_run_through(spread, b);
+        uint32_t ends = (run << 1) | (run >> 1);
+        ends &= ~run;
+        bool blockedBoth = (ends & g->lineBits[p ^ 1][d][idx]) == ends;
+        if (!Rule::fiveWins(p, board_popcount(run), blockedBoth)) continue;
+        w->runs[d] = run;
+        won = true;
+    }
+    return won;
+}
+
+// 把 winMarks 从当前的 g->win 切换到 w：只清除、设置两组连子所在的格子
+template <int N>
+static inline void board_show_win(GomokuGame* g, const WinState& w) {
+    for (int k = 0; k < 2; k++) {
+        const WinState& s = k == 0 ? g->win : w;
+        for (int d = 0; d < LINE_DIRS; d++) {
+            int idx = board_line_index<N>(d, s.row, s.col);
+            for (uint32_t run = s.runs[d]; run; run &= run - 1) {
+                int r, c;
+                board_line_cell<N>(d, idx, board_lowest_bit(run), &r, &c);
+                g->winMarks[r][c] = k;
+            }
+        }
+    }
+    g->win = w;
+}
+
+#endif // GOMOKU_MOVES_H
@@ -0,0 +1,249 @@
+#include "gomoku_board.h"
+#include "gomoku_nnue.h"
+#include <new>
+#include <stdio.h>
+#include <string.h>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NNUE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define NNUE_AVX2_TARGET
+#else
+#define NNUE_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+// 网络权重与推理。权重是进程内唯一的一份，启用了网络的句柄都指向它。
+// 推理用 int16 累加器与 int8 权重：x86 上运行时检测 AVX2，不需要编译选项；其余平台与老 CPU 走标量版本，
+// 两者结果逐位相同（maddubs 的 int16 中间和最大 127 * 128 * 2，不会饱和）。
+
+static NnueNetwork nnueNet_internal;
+static bool nnueLoaded_internal;
+
+#ifdef NNUE_X86
+static bool nnue_cpu_has_avx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] >> 27) & 1, avx = (info[2] >> 28) & 1;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 5) & 1;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static const bool nnueAvx2_internal = nnue_cpu_has_avx2();
+#endif
+
+static inline uint8_t nnue_clip(int x) {
+    return (uint8_t)(x < 0 ? 0 : (x > 127 ? 127 : x));
+}
+
+// ----------------- 标量版本 -----------------
+
+static void nnue_update_scalar(const NnueNetwork* net, NnueAccumulator acc, int p, int cell, int delta) {
+    for (int v = 0; v < 2; v++) {
+        const int16_t* w = net->w1[(p ^ v) * NNUE_CELLS + cell];
+        int16_t* a = acc[v];
+        if (delta > 0) {
+            for (int i = 0; i < NNUE_HIDDEN; i++) a[i] = (int16_t)(a[i] + w[i]);
+        }
+        else {
+            for (int i = 0; i < NNUE_HIDDEN; i++) a[i] = (int16_t)(a[i] - w[i]);
+        }
+    }
+}
+
+static int nnue_evaluate_scalar(const NnueNetwork* net, const NnueAccumulator acc, int p) {
+    uint8_t in[2 * NNUE_HIDDEN];
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        in[i] = nnue_clip(acc[p][i]);
+        in[NNUE_HIDDEN + i] = nnue_clip(acc[p ^ 1][i]);
+    }
+    int out = net->bo;
+    for (int j = 0; j < NNUE_L2; j++) {
+        int sum = net->b2[j];
+        for (int i = 0; i < 2 * NNUE_HIDDEN; i++) sum += in[i] * net->w2[j][i];
+        out += nnue_clip(sum >> NNUE_L2_SHIFT) * net->wo[j];
+    }
+    return (int)((int64_t)out * net->outputScale >> 16);
+}
+
+// ----------------- AVX2 版本 -----------------
+
+#ifdef NNUE_X86
+NNUE_AVX2_TARGET
+static void nnue_update_avx2(const NnueNetwork* net, NnueAccumulator acc, int p, int cell, int delta) {
+    for (int v = 0; v < 2; v++) {
+        const __m256i* w = (const __m256i*)net->w1[(p ^ v) * NNUE_CELLS + cell];
+        __m256i* a = (__m256i*)acc[v];
+        for (int i = 0; i < NNUE_HIDDEN / 16; i++) {
+            __m256i x = _mm256_loadu_si256(a + i), y = _mm256_loadu_si256(w + i);
+            _mm256_storeu_si256(a + i, delta > 0 ? _mm256_add_epi16(x, y) : _mm256_sub_epi16(x, y));
+        }
+    }
+}
+
+NNUE_AVX2_TARGET
+static inline int nnue_hsum_avx2(__m256i x) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    return _mm_cvtsi128_si32(s);
+}
+
+// 四个向量各自横向求和，结果依次放在 4 个 int32 中
+NNUE_AVX2_TARGET
+static inline __m128i nnue_hsum4_avx2(__m256i a, __m256i b, __m256i c, __m256i d) {
+    a = _mm256_hadd_epi32(_mm256_hadd_epi32(a, b), _mm256_hadd_epi32(c, d));
+    return _mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+}
+
+// uint8 输入与 int8 权重的 32 字节块点积，结果为 8 个 int32 部分和
+NNUE_AVX2_TARGET
+static inline __m256i nnue_dot32_avx2(__m256i x, __m256i w) {
+    return _mm256_madd_epi16(_mm256_maddubs_epi16(x, w), _mm256_set1_epi16(1));
+}
+
+NNUE_AVX2_TARGET
+static int nnue_evaluate_avx2(const NnueNetwork* net, const NnueAccumulator acc, int p) {
+    // 截断到 [0,127] 并压成 uint8：packs 按 128 位分道交错，再用 permute 还原顺序
+    __m256i in[2 * NNUE_HIDDEN / 32];
+    const __m256i zero = _mm256_setzero_si256();
+    for (int v = 0; v < 2; v++) {
+        const __m256i* a = (const __m256i*)acc[p ^ v];
+        for (int i = 0; i < NNUE_HIDDEN / 32; i++) {
+            __m256i packed = _mm256_packs_epi16(_mm256_loadu_si256(a + 2 * i), _mm256_loadu_si256(a + 2 * i + 1));
+            in[v * (NNUE_HIDDEN / 32) + i] = _mm256_max_epi8(_mm256_permute4x64_epi64(packed, 0xD8), zero);
+        }
+    }
+    // 隐层每次算 4 个输出；移位后经两次饱和压缩与取非负，恰好是截断到 [0,127]
+    __m128i hidden32[NNUE_L2 / 4];
+    for (int j = 0; j < NNUE_L2; j += 4) {
+        __m256i sum[4];
+        for (int k = 0; k < 4; k++) {
+            const __m256i* w = (const __m256i*)net->w2[j + k];
+            sum[k] = zero;
+            for (int i = 0; i < 2 * NNUE_HIDDEN / 32; i++) {
+                sum[k] = _mm256_add_epi32(sum[k], nnue_dot32_avx2(in[i], _mm256_loadu_si256(w + i)));
+            }
+        }
+        __m128i s = _mm_add_epi32(nnue_hsum4_avx2(sum[0], sum[1], sum[2], sum[3]),
+            _mm_loadu_si128((const __m128i*)(net->b2 + j)));
+        hidden32[j / 4] = _mm_srai_epi32(s, NNUE_L2_SHIFT);
+    }
+    __m128i h16[NNUE_L2 / 8], h8[NNUE_L2 / 16];
+    for (int i = 0; i < NNUE_L2 / 8; i++) h16[i] = _mm_packs_epi32(hidden32[2 * i], hidden32[2 * i + 1]);
+    for (int i = 0; i < NNUE_L2 / 16; i++) h8[i] = _mm_max_epi8(_mm_packs_epi16(h16[2 * i], h16[2 * i + 1]), _mm_setzero_si128());
+    __m256i h = _mm256_set_m128i(h8[1], h8[0]);
+    int out = net->bo + nnue_hsum_avx2(nnue_dot32_avx2(h, _mm256_loadu_si256((const __m256i*)net->wo)));
+    return (int)((int64_t)out * net->outputScale >> 16);
+}
+#endif
+
+// ----------------- 内部接口 -----------------
+
+void nnue_update(const NnueNetwork* net, NnueAccumulator acc, int p, int cell, int delta) {
+#ifdef NNUE_X86
+    if (nnueAvx2_internal) {
+        nnue_update_avx2(net, acc, p, cell, delta);
+        return;
+    }
+#endif
+    nnue_update_scalar(net, acc, p, cell, delta);
+}
+
+void nnue_refresh(const NnueNetwork* net, NnueAccumulator acc, const GomokuGame* g) {
+    memcpy(acc[0], net->b1, sizeof(net->b1));
+    memcpy(acc[1], net->b1, sizeof(net->b1));
+    for (int p = 0; p < 2; p++) {
+        for (int r = 0; r < g->size; r++) {
+            for (uint32_t bits = g->lineBits[p][0][r] >> LINE_PAD; bits; bits &= bits - 1) {
+                nnue_update(net, acc, p, board_cell_index(r, board_lowest_bit(bits)), 1);
+            }
+        }
+    }
+}
+
+int nnue_evaluate(const NnueNetwork* net, const NnueAccumulator acc, int p) {
+#ifdef NNUE_X86
+    if (nnueAvx2_internal) return nnue_evaluate_avx2(net, acc, p);
+#endif
+    return nnue_evaluate_scalar(net, acc, p);
+}
+
+// ----------------- 载入与启用 -----------------
+
+static uint32_t nnue_fnv1a(uint32_t h, const void* data, size_t bytes) {
+    const unsigned char* s = (const unsigned char*)data;
+    for (size_t i = 0; i < bytes; i++) h = (h ^ s[i]) * 16777619u;
+    return h;
+}
+
+// 读入一段数据并累计校验和
+static bool nnue_read(FILE* fp, void* data, size_t bytes, uint32_t* checksum) {
+    if (fread(data, 1, bytes, fp) != bytes) return false;
+    *checksum = nnue_fnv1a(*checksum, data, bytes);
+    return true;
+}
+
+static bool nnue_read_network(FILE* fp, NnueNetwork* net) {
+    NnueFileHeader h;
+    if (fread(&h, sizeof(h), 1, fp) != 1) return false;
+    if (memcmp(h.magic, NNUE_MAGIC, sizeof(h.magic)) != 0 || h.version != NNUE_VERSION) return false;
+    if (h.features != NNUE_FEATURES || h.hidden != NNUE_HIDDEN || h.l2 != NNUE_L2) return false;
+    if (h.boardSize != 0 && h.boardSize != 15 && h.boardSize != 19 && h.boardSize != 20) return false;
+    uint32_t checksum = 2166136261u;
+    if (!nnue_read(fp, net->w1, sizeof(net->w1), &checksum)
+        || !nnue_read(fp, net->b1, sizeof(net->b1), &checksum)
+        || !nnue_read(fp, net->w2, sizeof(net->w2), &checksum)
+        || !nnue_read(fp, net->b2, sizeof(net->b2), &checksum)
+        || !nnue_read(fp, net->wo, sizeof(net->wo), &checksum)
+        || !nnue_read(fp, &net->bo, sizeof(net->bo), &checksum)) {
+        return false;
+    }
+    if (checksum != h.checksum || fgetc(fp) != EOF) return false;
+    net->outputScale = h.outputScale;
+    net->boardSize = (int)h.boardSize;
+    return true;
+}
+
+bool gomoku_nnue_load(const char* filename) {
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) return false;
+    // 先读到临时副本，文件损坏时保留原来的网络
+    NnueNetwork* net = new (std::nothrow) NnueNetwork;
+    bool ok = net && nnue_read_network(fp, net);
+    fclose(fp);
+    if (ok) {
+        memcpy(&nnueNet_internal, net, sizeof(NnueNetwork));
+        nnueLoaded_internal = true;
+    }
+    delete net;
+    return ok;
+}
+
+bool gomoku_nnue_loaded(void) {
+    return nnueLoaded_internal;
+}
+
+bool gomoku_game_set_nnue(GomokuGame* g, bool enable) {
+    if (!enable) {
+        g->nnue = NULL;
+        return true;
+    }
+    const NnueNetwork* net = &nnueNet_internal;
+    if (!nnueLoaded_internal || (net->boardSize && net->boardSize != g->size)) return false;
+    g->nnue = net;
+    nnue_refresh(net, g->nnueAcc, g);
+    return true;
+}
+
+bool gomoku_game_nnue_enabled(const GomokuGame* g) {
+    return g->nnue != NULL;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#ifndef GOMOKU_NNUE_H
+#define GOMOKU_NNUE_H
+#include "gomoku_logic.h"
+#include <stdint.h>
+
+// 可增量更新的神经网络评估（NNUE，逻辑层内部使用）。
+// 输入特征按“己方/对方 × 格子”编号：feature = side * NNUE_CELLS + r * GOMOKU_MAX_SIZE + c，
+// 与 Zobrist 键、置换表着法编码一致，不随棋盘尺寸变化（网络文件里记录它针对的尺寸）。
+// 第一层对两个视角各维护一组累加器：acc[0] 以 'X' 为己方，acc[1] 以 'O' 为己方。落子/提子时只把
+// 该格对应的两行权重加到/减出累加器，评估时不必重算整个棋盘。
+//
+// 网络结构与量化（训练端须按此导出）：
+//   累加器  int16[2][NNUE_HIDDEN] = b1 + Σ W1[feature]
+//   输入    uint8[2 * NNUE_HIDDEN] = clamp(acc[走棋方], 0, 127) ‖ clamp(acc[对方], 0, 127)
+//   隐层    uint8[NNUE_L2] = clamp((b2 + W2 · 输入) >> NNUE_L2_SHIFT, 0, 127)，W2 为 int8
+//   输出    int32 = bo + Wo · 隐层，Wo 为 int8；评估分 = 输出 * outputScale >> 16，以走棋方为正
+//
+// 文件格式（小端）：NnueFileHeader 之后依次为 W1 int16[NNUE_FEATURES][NNUE_HIDDEN]、b1 int16[NNUE_HIDDEN]、
+// W2 int8[NNUE_L2][2 * NNUE_HIDDEN]、b2 int32[NNUE_L2]、Wo int8[NNUE_L2]、bo int32；
+// checksum 为这些数据的 FNV-1a 32 位校验和。
+
+#define NNUE_CELLS (GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE)
+#define NNUE_FEATURES (2 * NNUE_CELLS)
+#define NNUE_HIDDEN 128
+#define NNUE_L2 32
+#define NNUE_L2_SHIFT 6
+#define NNUE_VERSION 1
+#define NNUE_MAGIC "GMKNNUE"
+
+struct NnueFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t boardSize;       // 0 表示不限尺寸
+    uint32_t features, hidden, l2;
+    int32_t outputScale;
+    uint32_t checksum;
+};
+
+struct alignas(64) NnueNetwork {
+    int16_t w1[NNUE_FEATURES][NNUE_HIDDEN];
+    int16_t b1[NNUE_HIDDEN];
+    int8_t w2[NNUE_L2][2 * NNUE_HIDDEN];
+    int32_t b2[NNUE_L2];
+    int8_t wo[NNUE_L2];
+    int32_t bo;
+    int32_t outputScale;
+    int boardSize;
+};
+
+typedef int16_t NnueAccumulator[2][NNUE_HIDDEN];
+
+// 玩家 p（0 为 'X'）在 cell 落子（delta = 1）或提子（delta = -1）时更新两个视角的累加器
+void nnue_update(const NnueNetwork* net, NnueAccumulator acc, int p, int cell, int delta);
+
+// 按棋盘重新计算累加器（开局、启用网络时使用）
+void nnue_refresh(const NnueNetwork* net, NnueAccumulator acc, const GomokuGame* g);
+
+// 走棋方 p 视角的评估分
+int nnue_evaluate(const NnueNetwork* net, const NnueAccumulator acc, int p);
+
+#endif // GOMOKU_NNUE_H
@@ -0,0 +1,132 @@
+#include "gomoku_patterns.h"
+
+// 棋形表在编译期生成：先对单方视角的 3^8 种 (己方, 阻挡) 组合分类，再展开成 2 位编码的 65536 项双方表。
+// MSVC 需要较大的 /constexpr:steps（见工程文件）。
+
+#define WINDOW_CELLS 9
+#define CENTER_BIT (1u << PATTERN_WINDOW)
+#define WINDOW_MASK ((1u << WINDOW_CELLS) - 1)
+#define TERNARY_SIZE 6561
+
+struct ShapeTable3 {
+    uint8_t shape[TERNARY_SIZE];
+};
+
+// 9 格窗口内所有包含中心的 5 格段（起点 0..4）中，己方 4 子加 1 空时那个空位即成五点
+static constexpr uint32_t five_points(uint32_t own, uint32_t empty) {
+    uint32_t points = 0;
+    for (int s = 0; s + 5 <= WINDOW_CELLS; s++) {
+        uint32_t seg = 0x1Fu << s;
+        uint32_t gap = seg & ~own;
+        if ((gap & (gap - 1)) == 0 && (gap & empty) == gap && gap != 0) points |= gap;
+    }
+    return points;
+}
+
+static constexpr bool has_five(uint32_t own) {
+    for (int s = 0; s + 5 <= WINDOW_CELLS; s++)
+        if ((own & (0x1Fu << s)) == (0x1Fu << s)) return true;
+    return false;
+}
+
+static constexpr int popcount9(uint32_t x) {
+    int n = 0;
+    for (; x; x &= x - 1) n++;
+    return n;
+}
+
+// 成五点中是否有相距 5 格的一对（中间 4 格必为己方），即活四
+static constexpr bool is_open_four(uint32_t points) {
+    return (points & (points >> 5)) != 0;
+}
+
+static constexpr int four_shape(uint32_t own, uint32_t empty) {
+    uint32_t points = five_points(own, empty);
+    if (!points) return SHAPE_NONE;
+    if (is_open_four(points)) return SHAPE_OPEN_FOUR;
+    return popcount9(points) >= 2 ? SHAPE_DOUBLE_FOUR : SHAPE_CLOSED_FOUR;
+}
+
+// 己方 own（已含中心）在空位 empty 上还能形成的棋形
+static constexpr int classify(uint32_t own, uint32_t empty) {
+    if (has_five(own)) return SHAPE_FIVE;
+    int four = four_shape(own, empty);
+    if (four != SHAPE_NONE) return four;
+
+    bool closedThree = false, splitThree = false, openThree = false;
+    for (uint32_t e = empty; e; e &= e - 1) {
+        uint32_t bit = e & (0u - e);
+        int next = four_shape(own | bit, empty & ~bit);
+        if (next == SHAPE_OPEN_FOUR) {
+            // 补在两端为连活三，补在中间空隙为跳活三
+            uint32_t stones = own | bit;
+            bool gapFill = (stones & (bit << 1)) && (stones & (bit >> 1));
+            if (gapFill) splitThree = true;
+            else openThree = true;
+        }
+        else if (next != SHAPE_NONE) {
+            closedThree = true;
+        }
+    }
+    if (openThree) return SHAPE_OPEN_THREE;
+    if (splitThree) return SHAPE_SPLIT_THREE;
+    if (closedThree) return SHAPE_CLOSED_THREE;
+
+    // 活二：某个 6 格段两端为空，中间 4 格无阻挡且恰有 2 子（含中心）
+    for (int s = 0; s + 6 <= WINDOW_CELLS; s++) {
+        uint32_t inner = 0x0Fu << (s + 1);
+        uint32_t ends = (1u << s) | (1u << (s + 5));
+        if (!(inner & CENTER_BIT)) continue;
+        if ((ends & empty) != ends) continue;
+        if ((inner & (own | empty)) != inner) continue;
+        if (popcount9(own & inner) == 2) return SHAPE_TWO;
+    }
+    return SHAPE_NONE;
+}
+
+// 8 位邻格掩码展开成以中心为第 4 位的 9 位窗口
+static constexpr uint32_t expand8(uint32_t m) {
+    return (m & 0x0Fu) | ((m & 0xF0u) << 1);
+}
+
+static constexpr int ternary8(uint32_t m) {
+    int v = 0, w = 1;
+    for (int i = 0; i < 8; i++) {
+        if (m & (1u << i)) v += w;
+        w *= 3;
+    }
+    return v;
+}
+
+static constexpr ShapeTable3 make_shape_table3() {
+    ShapeTable3 t = {};
+    for (int i = 0; i < TERNARY_SIZE; i++) {
+        uint32_t own = 0, blocked = 0;
+        int v = i;
+        for (int k = 0; k < 8; k++) {
+            if (v % 3 == 1) own |= 1u << k;
+            else if (v % 3 == 2) blocked |= 1u << k;
+            v /= 3;
+        }
+        uint32_t own9 = expand8(own) | CENTER_BIT;
+        uint32_t empty9 = WINDOW_MASK & ~own9 & ~expand8(blocked);
+        t.shape[i] = (uint8_t)classify(own9, empty9);
+    }
+    return t;
+}
+
+static constexpr PatternTable make_pattern_table() {
+    ShapeTable3 t3 = make_shape_table3();
+    PatternTable t = {};
+    for (uint32_t idx = 0; idx < PATTERN_TABLE_SIZE; idx++) {
+        uint32_t x8 = idx & 0xFFu, o8 = idx >> 8;
+        int sx = t3.shape[ternary8(x8 & ~o8) + 2 * ternary8(o8)];
+        int so = t3.shape[ternary8(o8 & ~x8) + 2 * ternary8(x8)];
+        t.entry[idx] = (uint8_t)(sx | (so << 4));
+    }
+    return t;
+}
+
+// 先以 constexpr 变量求值，保证整张表在编译期完成；外部可见的对象由它常量初始化
+static constexpr PatternTable patternTableInit_internal = make_pattern_table();
+extern const PatternTable gomoku_pattern_table = patternTableInit_internal;
@@ -0,0 +1,48 @@
+#pragma once
+#ifndef GOMOKU_PATTERNS_H
+#define GOMOKU_PATTERNS_H
+#include <stdint.h>
+
+// 线型查表（逻辑层内部使用）。
+// 以待评估的空位为中心，取同一条线上左右各 4 格共 8 个邻格，每格 2 位：
+//   X 位 = 该格为 'X' 或棋盘外，O 位 = 该格为 'O' 或棋盘外（两位都置位即为棋盘外）。
+// 索引 = x8 | (o8 << 8)，x8/o8 的第 0..3 位对应中心左侧 -4..-1，第 4..7 位对应右侧 +1..+4。
+// 表项低 4 位是 'X' 在中心落子后这条线上形成的棋形，高 4 位是 'O' 的，一次读取得到双方结果。
+
+enum GomokuShape {
+    SHAPE_NONE = 0,
+    SHAPE_TWO,          // 活二：再补两子可成活四
+    SHAPE_CLOSED_THREE, // 眠三：再补一子只能成冲四
+    SHAPE_SPLIT_THREE,  // 跳活三：补中间空位可成活四
+    SHAPE_OPEN_THREE,   // 连活三：补端点可成活四
+    SHAPE_CLOSED_FOUR,  // 冲四：只有一个成五点
+    SHAPE_DOUBLE_FOUR,  // 同一条线上的两个冲四
+    SHAPE_OPEN_FOUR,    // 活四：两端都是成五点
+    SHAPE_FIVE          // 成五（含长连）
+};
+
+#define PATTERN_WINDOW 4
+#define PATTERN_TABLE_SIZE (1 << 16)
+
+struct PatternTable {
+    uint8_t entry[PATTERN_TABLE_SIZE];
+};
+
+extern const PatternTable gomoku_pattern_table;
+
+// 从线编码中取出以第 b 位为中心的 8 个邻格（b 之下至少留有 PATTERN_WINDOW 个位）
+static inline uint32_t pattern_window8(uint32_t bits, int b) {
+    uint32_t w = bits >> (b - PATTERN_WINDOW);
+    return (w & 0x0Fu) | ((w >> 1) & 0xF0u);
+}
+
+// x/o 为双方线编码，wall 为棋盘外的位；返回表项
+static inline uint8_t pattern_lookup(uint32_t x, uint32_t o, uint32_t wall, int b) {
+    return gomoku_pattern_table.entry[pattern_window8(x | wall, b) | (pattern_window8(o | wall, b) << 8)];
+}
+
+static inline int pattern_shape(uint8_t entry, int player) {
+    return player == 0 ? (entry & 0x0F) : (entry >> 4);
+}
+
+#endif // GOMOKU_PATTERNS_H
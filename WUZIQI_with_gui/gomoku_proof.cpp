@@ -0,0 +1,304 @@
+#include "gomoku_ai.h"
+#include "gomoku_threats.h"
+#include <new>
+#include <vector>
+
+// 证明数搜索（df-pn）：深度优先地展开证明数/反证数最小的分支，用置换表保存每个结点的 (pn, dn)，
+// 阈值不超过时才继续往下，因此总把力气花在最容易证明的那一支上，能做比 alpha-beta 深得多的证明。
+// 搜索空间与 gomoku_threats.h 相同：进攻方（OR 结点）走冲四和活三，防守方（AND 结点）走堵点、
+// 活三线段上的空位和反击的冲四，防守方的应手是完整的，证明出来的必胜就是真的必胜。
+// 置换表按给定的大小一次分配，桶内按子树规模淘汰，内存不会随搜索增长。
+// 先证明走棋方能否取胜，不能时再以对方为进攻方证明走棋方是否必败；两者共用节点预算。
+
+#define DFPN_INF 0x3FFFFFFFu
+#define DFPN_BUCKET_ENTRIES 4
+// 进攻方走到这么深还没赢就按反证处理，免得沿着接连冲四的长分支一路走到棋盘填满
+#define DFPN_MAX_PLY 40
+// 置换表键中区分进攻方与结点类型的掩码
+#define DFPN_ATTACKER_KEY 0xD1B54A32D192ED03ull
+#define DFPN_OR_KEY 0x8CB92BA72F3D8DD7ull
+
+struct DfpnEntry {
+    uint64_t key;
+    uint32_t pn, dn;
+    uint32_t work;  // 得出该结果时展开的结点数，淘汰时优先保留大的
+    uint32_t pad;
+};
+
+struct DfpnBucket {
+    DfpnEntry entries[DFPN_BUCKET_ENTRIES];
+};
+
+struct DfpnContext {
+    GomokuGame* game;
+    int attacker;
+    DfpnBucket* table;
+    uint64_t bucketMask;
+    uint64_t nodes;
+    uint64_t maxNodes;
+    bool stopped;
+    std::vector<AiMove> moves;  // 各层的子结点依次压栈，base 为本层的起点
+};
+
+static inline uint32_t dfpn_add(uint32_t a, uint32_t b) {
+    return a + b >= DFPN_INF ? DFPN_INF : a + b;
+}
+
+static inline uint64_t dfpn_key(const DfpnContext* c, uint64_t hash, bool orNode) {
+    return hash ^ (c->attacker ? DFPN_ATTACKER_KEY : 0) ^ (orNode ? DFPN_OR_KEY : 0)
+        ^ ((uint64_t)c->game->rule << 56) ^ ((uint64_t)c->game->size << 48);
+}
+
+// 查不到时按未展开的结点处理：pn = dn = 1
+static inline void dfpn_probe(const DfpnContext* c, uint64_t key, uint32_t* pn, uint32_t* dn) {
+    const DfpnBucket& b = c->table[key & c->bucketMask];
+    for (int i = 0; i < DFPN_BUCKET_ENTRIES; i++) {
+        if (b.entries[i].key == key && b.entries[i].work) {
+            *pn = b.entries[i].pn;
+            *dn = b.entries[i].dn;
+            return;
+        }
+    }
+    *pn = 1;
+    *dn = 1;
+}
+
+static inline void dfpn_store(DfpnContext* c, uint64_t key, uint32_t pn, uint32_t dn, uint64_t work) {
+    DfpnBucket& b = c->table[key & c->bucketMask];
+    int victim = 0;
+    for (int i = 0; i < DFPN_BUCKET_ENTRIES; i++) {
+        if (b.entries[i].key == key || !b.entries[i].work) {
+            victim = i;
+            break;
+        }
+        if (b.entries[i].work < b.entries[victim].work) victim = i;
+    }
+    DfpnEntry& e = b.entries[victim];
+    e.key = key;
+    e.pn = pn;
+    e.dn = dn;
+    e.work = work > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)(work ? work : 1);
+}
+
+// 展开一个结点：是终局时写入 *pn/*dn 并返回 -1，否则把子结点压到 moves[base..) 并返回个数
+template <int N, class Rule>
+static int dfpn_expand(DfpnContext* c, bool orNode, int ply, int base, uint32_t* pn, uint32_t* dn) {
+    GomokuGame* g = c->game;
+    int a = c->attacker, p = orNode ? a : a ^ 1;
+    if ((int)c->moves.size() < base + AI_MAX_MOVES) c->moves.resize(base + AI_MAX_MOVES);
+    AiMove* moves = &c->moves[base];
+    // 走棋方能成五：OR 结点证明成立，AND 结点反证成立
+    if (ai_five_points<N, Rule>(g, p, moves, 1) || g->moveCount >= N * N) {
+        bool proven = orNode && g->moveCount < N * N;
+        *pn = proven ? 0 : DFPN_INF;
+        *dn = proven ? DFPN_INF : 0;
+        return -1;
+    }
+    int n = ai_five_points<N, Rule>(g, p ^ 1, moves, 2);
+    if (n >= 2) {
+        // 对方有两个成五点：OR 结点（进攻方）堵不住，AND 结点（防守方）同样堵不住
+        *pn = orNode ? DFPN_INF : 0;
+        *dn = orNode ? 0 : DFPN_INF;
+        return -1;
+    }
+    if (n == 1) n = ai_remove_forbidden<N, Rule>(g, p, moves, 1);
+    else if (orNode) n = threat_generate<N, Rule>(g, a, true, moves);
+    else n = threat_defences<N, Rule>(g, a, moves);
+    if (n == 0 || (orNode && ply >= DFPN_MAX_PLY)) {
+        // 进攻方没有威胁可走或已经太深，或防守方唯一的堵点是禁手
+        bool proven = !orNode && ai_five_points<N, Rule>(g, a, moves, 1);
+        *pn = proven ? 0 : DFPN_INF;
+        *dn = proven ? DFPN_INF : 0;
+        return -1;
+    }
+    return n;
+}
+
+// 多重迭代加深：在 (thpn, thdn) 之内一直展开最有希望的子结点，结果存入置换表
+template <int N, class Rule>
+static void dfpn_mid(DfpnContext* c, bool orNode, uint32_t thpn, uint32_t thdn, int ply, int base) {
+    GomokuGame* g = c->game;
+    uint64_t key = dfpn_key(c, g->hash, orNode);
+    uint64_t start = c->nodes;
+    if (++c->nodes >= c->maxNodes) c->stopped = true;
+    uint32_t pn, dn;
+    int n = dfpn_expand<N, Rule>(c, orNode, ply, base, &pn, &dn);
+    if (n < 0) {
+        dfpn_store(c, key, pn, dn, 1);
+        return;
+    }
+    int side = orNode ? c->attacker : c->attacker ^ 1;
+    for (;;) {
+        // 子结点的 (pn, dn) 直接由子局面的哈希查表，不必落子
+        int best = 0;
+        uint32_t bestPn = DFPN_INF, bestDn = DFPN_INF, second = DFPN_INF;
+        pn = orNode ? DFPN_INF : 0;
+        dn = orNode ? 0 : DFPN_INF;
+        for (int i = 0; i < n; i++) {
+            const AiMove& m = c->moves[base + i];
+            uint64_t h = g->hash ^ gomoku_zobrist_keys.key[side][board_cell_index(m.row, m.col)];
+            uint32_t cpn, cdn;
+            dfpn_probe(c, dfpn_key(c, h, !orNode), &cpn, &cdn);
+            // 还没展开的活三比冲四难证明：防守方有好几种应手
+            if (orNode && cpn == 1 && cdn == 1 && m.score < THREAT_FOUR_BONUS) cpn = 2;
+            // OR 结点取证明数最小的子结点，AND 结点取反证数最小的；second 为次小值，用来定阈值
+            uint32_t v = orNode ? cpn : cdn, bestV = orNode ? bestPn : bestDn;
+            if (v < bestV) {
+                second = bestV;
+                best = i;
+                bestPn = cpn;
+                bestDn = cdn;
+            }
+            else if (v < second) {
+                second = v;
+            }
+            if (orNode) {
+                if (cpn < pn) pn = cpn;
+                dn = dfpn_add(dn, cdn);
+            }
+            else {
+                pn = dfpn_add(pn, cpn);
+                if (cdn < dn) dn = cdn;
+            }
+        }
+        if (pn >= thpn || dn >= thdn || c->stopped) break;
+        uint32_t childPn, childDn;
+        if (orNode) {
+            childPn = thpn < dfpn_add(second, 1) ? thpn : dfpn_add(second, 1);
+            childDn = dfpn_add(thdn - dn, bestDn);
+        }
+        else {
+            childDn = thdn < dfpn_add(second, 1) ? thdn : dfpn_add(second, 1);
+            childPn = dfpn_add(thpn - pn, bestPn);
+        }
+        ai_play<N, Rule>(g, c->moves[base + best]);
+        dfpn_mid<N, Rule>(c, !orNode, childPn, childDn, ply + 1, base + n);
+        board_undo_move<N>(g);
+    }
+    dfpn_store(c, key, pn, dn, c->nodes - start);
+}
+
+// 证明树的规模：OR 结点取一个已证明的子结点，AND 结点取全部子结点；
+// 只数置换表中还保留着的部分（被淘汰的子树按一个结点计），最多数到 limit
+template <int N, class Rule>
+static uint64_t dfpn_proof_size(DfpnContext* c, bool orNode, int ply, int base, uint64_t limit) {
+    GomokuGame* g = c->game;
+    uint32_t pn, dn;
+    int n = dfpn_expand<N, Rule>(c, orNode, ply, base, &pn, &dn);
+    if (n < 0) return 1;
+    int side = orNode ? c->attacker : c->attacker ^ 1;
+    uint64_t size = 1;
+    for (int i = 0; i < n && size < limit; i++) {
+        const AiMove m = c->moves[base + i];
+        uint64_t h = g->hash ^ gomoku_zobrist_keys.key[side][board_cell_index(m.row, m.col)];
+        uint32_t cpn, cdn;
+        dfpn_probe(c, dfpn_key(c, h, !orNode), &cpn, &cdn);
+        if (cpn != 0) {
+            if (!orNode) size++;
+            continue;
+        }
+        ai_play<N, Rule>(g, m);
+        size += dfpn_proof_size<N, Rule>(c, !orNode, ply + 1, base + n, limit - size);
+        board_undo_move<N>(g);
+        if (orNode) break;
+    }
+    return size;
+}
+
+// 以 attacker 为进攻方证明根结点（走棋方是 attacker 时为 OR 结点，否则为 AND 结点）。
+// 返回 true 表示证明成立；成立且根为 OR 结点时 *move 为必胜的一手
+template <int N, class Rule>
+static bool dfpn_solve(DfpnContext* c, int attacker, AiMove* move) {
+    GomokuGame* g = c->game;
+    c->attacker = attacker;
+    c->stopped = c->nodes >= c->maxNodes;
+    bool orNode = board_player_index(g->currentPlayer) == attacker;
+    uint32_t pn, dn;
+    dfpn_probe(c, dfpn_key(c, g->hash, orNode), &pn, &dn);
+    while (pn != 0 && dn != 0 && !c->stopped) {
+        dfpn_mid<N, Rule>(c, orNode, DFPN_INF, DFPN_INF, 0, 0);
+        dfpn_probe(c, dfpn_key(c, g->hash, orNode), &pn, &dn);
+    }
+    if (pn != 0) return false;
+    if (orNode) {
+        uint32_t tpn, tdn;
+        int n = dfpn_expand<N, Rule>(c, true, 0, 0, &tpn, &tdn);
+        if (n < 0) {
+            // 根结点就能成五
+            ai_five_points<N, Rule>(g, attacker, move, 1);
+            return true;
+        }
+        for (int i = 0; i < n; i++) {
+            const AiMove& m = c->moves[i];
+            uint64_t h = g->hash ^ gomoku_zobrist_keys.key[attacker][board_cell_index(m.row, m.col)];
+            uint32_t cpn, cdn;
+            dfpn_probe(c, dfpn_key(c, h, false), &cpn, &cdn);
+            if (cpn == 0) {
+                *move = m;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+template <int N, class Rule>
+static GomokuProofResult prove_internal(const GomokuGame* src, uint64_t maxNodes, int tableMb, GomokuProofStats* stats) {
+    ThreatClock::time_point start = ThreatClock::now();
+    memset(stats, 0, sizeof(*stats));
+    stats->row = stats->col = -1;
+    DfpnContext c;
+    c.game = gomoku_game_create_variant(src->size, src->rule);
+    if (!c.game) return GOMOKU_PROOF_UNKNOWN;
+    memcpy(c.game, src, sizeof(GomokuGame));
+    // 按 tableMb 向下取 2 的幂个桶；分配失败时逐次减半
+    uint64_t count = 1;
+    while (count * 2 * sizeof(DfpnBucket) <= (uint64_t)(tableMb > 0 ? tableMb : 1) * 1024 * 1024) count *= 2;
+    c.table = NULL;
+    while (!c.table && count >= 1024) {
+        c.table = new (std::nothrow) DfpnBucket[count]();
+        if (!c.table) count /= 2;
+    }
+    if (!c.table) {
+        gomoku_game_destroy(c.game);
+        return GOMOKU_PROOF_UNKNOWN;
+    }
+    c.bucketMask = count - 1;
+    c.nodes = 0;
+    c.maxNodes = maxNodes ? maxNodes : ~0ull;
+    c.moves.resize(AI_MAX_MOVES * 8);
+
+    int p = board_player_index(c.game->currentPlayer);
+    AiMove best = {};
+    GomokuProofResult result = GOMOKU_PROOF_UNKNOWN;
+    if (dfpn_solve<N, Rule>(&c, p, &best)) {
+        result = GOMOKU_PROOF_WIN;
+        stats->row = best.row;
+        stats->col = best.col;
+    }
+    else if (dfpn_solve<N, Rule>(&c, p ^ 1, &best)) {
+        result = GOMOKU_PROOF_LOSS;
+    }
+    stats->nodes = c.nodes;
+    if (result != GOMOKU_PROOF_UNKNOWN) {
+        bool orNode = board_player_index(c.game->currentPlayer) == c.attacker;
+        stats->proofSize = dfpn_proof_size<N, Rule>(&c, orNode, 0, 0, c.nodes);
+    }
+    stats->result = result;
+    stats->tableBytes = count * sizeof(DfpnBucket);
+    stats->timeMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(ThreatClock::now() - start).count();
+    delete[] c.table;
+    gomoku_game_destroy(c.game);
+    return result;
+}
+
+GomokuProofResult gomoku_game_prove(const GomokuGame* g, uint64_t maxNodes, int tableMb, GomokuProofStats* stats) {
+    GOMOKU_DISPATCH(g, prove_internal, g, maxNodes, tableMb, stats);
+}
+
+
+// ----------------- 默认实例上的全局接口 -----------------
+
+GomokuProofResult gomoku_prove(uint64_t maxNodes, int tableMb, GomokuProofStats* stats) {
+    return gomoku_game_prove(gomoku_default_game(), maxNodes, tableMb, stats);
+}
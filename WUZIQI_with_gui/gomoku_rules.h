@@ -0,0 +1,142 @@
+#pragma once
+#ifndef GOMOKU_RULES_H
+#define GOMOKU_RULES_H
+#include "gomoku_board.h"
+
+// 规则变体（逻辑层内部使用）。每种规则是一个编译期策略类，核心模板以 <N, Rule> 实例化，
+// 公共接口用 GOMOKU_DISPATCH 按 (g->size, g->rule) 分派，热点循环里不再判断规则。
+//   fiveWins(p, len, blockedBoth)：玩家 p（0 为 'X' 黑方）连成 len 子、两端是否都被对方堵住时是否获胜
+//   hasForbidden：黑方是否有禁手
+
+// 自由规则：五连及以上即胜
+struct RuleFreestyle {
+    static constexpr bool hasForbidden = false;
+    static inline bool fiveWins(int, int len, bool) { return len >= 5; }
+};
+
+// 标准规则：恰好五连才胜，长连不算
+struct RuleExactFive {
+    static constexpr bool hasForbidden = false;
+    static inline bool fiveWins(int, int len, bool) { return len == 5; }
+};
+
+// Caro：两端都被对方棋子堵住的五连不算胜（棋盘边缘不算堵）
+struct RuleCaro {
+    static constexpr bool hasForbidden = false;
+    static inline bool fiveWins(int, int len, bool blockedBoth) { return len >= 5 && !blockedBoth; }
+};
+
+// 连珠：黑方恰好五连才胜，且三三、四四、长连为禁手；白方五连及以上即胜、无禁手
+struct RuleRenju {
+    static constexpr bool hasForbidden = true;
+    static inline bool fiveWins(int p, int len, bool) { return p == 0 ? len == 5 : len >= 5; }
+};
+
+#define GOMOKU_DISPATCH_RULE(n, g, fn, ...) \
+    switch ((g)->rule) { \
+    case GOMOKU_RULE_EXACT_FIVE: return fn<n, RuleExactFive>(__VA_ARGS__); \
+    case GOMOKU_RULE_CARO: return fn<n, RuleCaro>(__VA_ARGS__); \
+    case GOMOKU_RULE_RENJU: return fn<n, RuleRenju>(__VA_ARGS__); \
+    default: return fn<n, RuleFreestyle>(__VA_ARGS__); \
+    }
+
+// 按棋盘尺寸与规则分派到 fn<N, Rule>
+#define GOMOKU_DISPATCH(g, fn, ...) \
+    switch ((g)->size) { \
+    case 19: GOMOKU_DISPATCH_RULE(19, g, fn, __VA_ARGS__) \
+    case 20: GOMOKU_DISPATCH_RULE(20, g, fn, __VA_ARGS__) \
+    default: GOMOKU_DISPATCH_RULE(GOMOKU_SIZE, g, fn, __VA_ARGS__) \
+    }
+
+
+// ----------------- 连珠禁手 -----------------
+// 禁手判定分两步：
+// 1. 候选：自由规则的棋形表是连珠棋形的上界（恰好五连的成五点一定也是自由规则的成五点），
+//    黑方落子后至少两条线不低于跳活三、或某条线成五/长连/同线双四的空位才可能是禁手。
+//    这些空位按线保存在 renjuLines 中，随威胁位一起在落子/悔棋时增量更新（见 gomoku_moves.h）。
+// 2. 精确判定：只对候选格在四条线上用位运算数出恰好成五的点，得到四、活三与长连。
+//    活三只要求补一子后成活四，不再递归检查那个补子点本身是否为禁手，因此单格判定是常数时间。
+
+// 黑方线编码 x（已含第 b 位）中，补上后形成恰好五连且连子经过 b 的空位
+static inline uint32_t renju_five_points(uint32_t x, uint32_t empty, int b) {
+    uint32_t points = 0;
+    for (uint32_t e = empty & (0x1FFu << (b - PATTERN_WINDOW)); e; e &= e - 1) {
+        int q = board_lowest_bit(e);
+        uint32_t run = board_run_through(x | (1u << q), q);
+        if (((run >> b) & 1u) && board_popcount(run) == 5) points |= 1u << q;
+    }
+    return points;
+}
+
+// 成五点中相距 5 格的一对是同一个活四（中间 4 格必为黑子），只算一个四
+static inline int renju_count_fours(uint32_t points) {
+    return board_popcount(points) - board_popcount(points & (points >> 5));
+}
+
+struct RenjuLineShape {
+    int fours;
+    bool three;
+    bool five;
+    bool overline;
+};
+
+// 黑方在第 b 位落子后这条线上的棋形；x 为黑子、empty 为棋盘内空位（都不含 b）
+static inline RenjuLineShape renju_line_shape(uint32_t x, uint32_t empty, int b) {
+    RenjuLineShape s = { 0, false, false, false };
+    x |= 1u << b;
+    int len = board_popcount(board_run_through(x, b));
+    s.five = len == 5;
+    s.overline = len > 5;
+    if (len >= 5) return s;
+    s.fours = renju_count_fours(renju_five_points(x, empty, b));
+    if (s.fours) return s;
+    for (uint32_t e = empty & (0x1FFu << (b - PATTERN_WINDOW)); e; e &= e - 1) {
+        uint32_t bit = e & (0u - e);
+        uint32_t points = renju_five_points(x | bit, empty & ~bit, b);
+        if (points & (points >> 5)) {
+            s.three = true;
+            break;
+        }
+    }
+    return s;
+}
+
+// 黑方在空位 (r,c) 落子是否为禁手；成五优先于禁手
+template <int N>
+static inline bool renju_is_forbidden(const GomokuGame* g, int r, int c) {
+    int fours = 0, threes = 0;
+    bool overline = false;
+    for (int d = 0; d < LINE_DIRS; d++) {
+        int idx = board_line_index<N>(d, r, c);
+        int b = board_line_pos(d, r, c);
+        uint32_t x = g->lineBits[0][d][idx];
+        uint32_t empty = board_line_mask<N>(d, idx) & ~(x | g->lineBits[1][d][idx]) & ~(1u << b);
+        RenjuLineShape s = renju_line_shape(x, empty, b);
+        if (s.five) return false;
+        overline |= s.overline;
+        fours += s.fours;
+        threes += s.three;
+    }
+    return overline || fours >= 2 || threes >= 2;
+}
+
+// 第 r 行的禁手候选格：至少两个方向不低于跳活三，或某个方向成五/长连/同线双四
+static inline uint32_t renju_candidate_row(const GomokuGame* g, int r) {
+    uint32_t a0 = g->renjuRows[0][0][r], a1 = g->renjuRows[0][1][r];
+    uint32_t a2 = g->renjuRows[0][2][r], a3 = g->renjuRows[0][3][r];
+    uint32_t twoOrMore = (a0 & (a1 | a2 | a3)) | (a1 & (a2 | a3)) | (a2 & a3);
+    return twoOrMore | g->renjuRows[1][0][r] | g->renjuRows[1][1][r] | g->renjuRows[1][2][r] | g->renjuRows[1][3][r];
+}
+
+// 第 r 行中黑方的禁手点
+template <int N>
+static inline uint32_t renju_forbidden_row(const GomokuGame* g, int r) {
+    uint32_t forbidden = 0;
+    for (uint32_t e = renju_candidate_row(g, r); e; e &= e - 1) {
+        int c = board_lowest_bit(e);
+        if (renju_is_forbidden<N>(g, r, c)) forbidden |= 1u << c;
+    }
+    return forbidden;
+}
+
+#endif // GOMOKU_RULES_H
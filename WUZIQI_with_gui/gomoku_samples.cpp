@@ -0,0 +1,161 @@
+#include "gomoku_samples.h"
+#include "gomoku_board.h"
+#include "gomoku_mmap.h"
+#include "gomoku_symmetry.h"
+#include <new>
+#include <stdio.h>
+#include <string.h>
+
+// 训练样本的打包与分片文件。分片只追加定长样本，文件按小端直接读写结构体。
+
+#define SAMPLE_PLANE_BYTES ((GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE + 7) / 8)
+
+static_assert(sizeof(GomokuSample) == GOMOKU_SAMPLE_BYTES && sizeof(GomokuSampleHeader) == GOMOKU_SAMPLE_HEADER_BYTES,
+    "sample layout");
+
+struct GomokuSampleWriter {
+    FILE* fp;
+    bool ok;
+};
+
+struct GomokuSampleShard {
+    MappedFile file;
+};
+
+void gomoku_sample_pack(const GomokuGame* g, int score, int row, int col, GomokuSample* sample) {
+    memset(sample, 0, sizeof(*sample));
+    int n = g->size;
+    for (int p = 0; p < 2; p++) {
+        for (int r = 0; r < n; r++) {
+            for (uint32_t bits = g->lineBits[p][0][r] >> LINE_PAD; bits; bits &= bits - 1) {
+                int i = r * n + board_lowest_bit(bits);
+                sample->stones[p][i >> 3] |= (uint8_t)(1u << (i & 7));
+            }
+        }
+    }
+    sample->score = score;
+    sample->ply = (uint16_t)g->moveCount;
+    sample->sideToMove = (uint8_t)board_player_index(g->currentPlayer);
+    sample->row = (uint8_t)row;
+    sample->col = (uint8_t)col;
+}
+
+bool gomoku_sample_unpack(const GomokuSample* sample, int size, GomokuRule rule, GomokuGame* g) {
+    int moves[2][GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE][2];
+    int count[2] = { 0, 0 };
+    for (int p = 0; p < 2; p++) {
+        for (int i = 0; i < size * size; i++) {
+            if (!((sample->stones[p][i >> 3] >> (i & 7)) & 1)) continue;
+            moves[p][count[p]][0] = i / size;
+            moves[p][count[p]][1] = i % size;
+            count[p]++;
+        }
+    }
+    if (count[0] - count[1] != sample->sideToMove || !gomoku_game_init_variant(g, size, rule)) return false;
+    int order[GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE][2];
+    for (int i = 0; i < count[0] + count[1]; i++) {
+        order[i][0] = moves[i & 1][i >> 1][0];
+        order[i][1] = moves[i & 1][i >> 1][1];
+    }
+    return gomoku_game_load_moves(g, order, count[0] + count[1]);
+}
+
+// 位平面中从第 off 位起的 n 位（n <= 20，跨不到 4 个字节以外）
+static uint32_t sample_bits(const uint8_t* plane, int off, int n) {
+    uint32_t w = 0;
+    for (int k = 0, b = off >> 3; k < 4 && b + k < SAMPLE_PLANE_BYTES; k++) {
+        w |= (uint32_t)plane[b + k] << (8 * k);
+    }
+    return (w >> (off & 7)) & ((1u << n) - 1);
+}
+
+void gomoku_sample_transform(const GomokuSample* sample, int size, int symmetry, GomokuSample* out) {
+    if (symmetry < 0 || symmetry >= SYMMETRY_COUNT) symmetry = 0;
+    SymmetryBoard b = {};
+    for (int p = 0; p < 2; p++) {
+        for (int r = 0; r < size; r++) b.rows[p][r] = sample_bits(sample->stones[p], r * size, size);
+    }
+    symmetry_board_transform(&b, size, symmetry, &b);
+    int row, col;
+    symmetry_apply(symmetry, size, sample->row, sample->col, &row, &col);
+    if (out != sample) *out = *sample;
+    memset(out->stones, 0, sizeof(out->stones));
+    for (int p = 0; p < 2; p++) {
+        for (int r = 0; r < size; r++) {
+            // 每行至多 20 位，从第 r * size 位起写入，跨不到 4 个字节以外
+            uint32_t w = b.rows[p][r] << ((r * size) & 7);
+            for (int k = 0, i = (r * size) >> 3; w && i + k < SAMPLE_PLANE_BYTES; k++, w >>= 8) {
+                out->stones[p][i + k] |= (uint8_t)w;
+            }
+        }
+    }
+    out->row = (uint8_t)row;
+    out->col = (uint8_t)col;
+}
+
+GomokuSampleWriter* gomoku_sample_writer_open(const char* filename, int size, GomokuRule rule, uint32_t shard, uint64_t seed) {
+    GomokuSampleWriter* w = new (std::nothrow) GomokuSampleWriter();
+    if (!w) return NULL;
+    w->fp = fopen(filename, "wb");
+    GomokuSampleHeader h = {};
+    memcpy(h.magic, GOMOKU_SAMPLE_MAGIC, sizeof(h.magic));
+    h.version = GOMOKU_SAMPLE_VERSION;
+    h.sampleBytes = GOMOKU_SAMPLE_BYTES;
+    h.size = (uint8_t)size;
+    h.rule = (uint8_t)rule;
+    h.shard = shard;
+    h.seed = seed;
+    if (!w->fp || fwrite(&h, sizeof(h), 1, w->fp) != 1) {
+        if (w->fp) fclose(w->fp);
+        delete w;
+        return NULL;
+    }
+    w->ok = true;
+    return w;
+}
+
+bool gomoku_sample_writer_add(GomokuSampleWriter* writer, const GomokuSample* samples, int count) {
+    if (count > 0 && fwrite(samples, sizeof(GomokuSample), (size_t)count, writer->fp) != (size_t)count) writer->ok = false;
+    return writer->ok;
+}
+
+bool gomoku_sample_writer_close(GomokuSampleWriter* writer) {
+    if (!writer) return true;
+    bool ok = writer->ok && file_sync(writer->fp);
+    ok = fclose(writer->fp) == 0 && ok;
+    delete writer;
+    return ok;
+}
+
+GomokuSampleShard* gomoku_sample_shard_open(const char* filename) {
+    GomokuSampleShard* s = new (std::nothrow) GomokuSampleShard();
+    if (!s) return NULL;
+    const GomokuSampleHeader* h = NULL;
+    if (mapped_file_open(&s->file, filename) && s->file.size >= sizeof(GomokuSampleHeader)) {
+        h = (const GomokuSampleHeader*)s->file.data;
+    }
+    if (!h || memcmp(h->magic, GOMOKU_SAMPLE_MAGIC, sizeof(h->magic)) != 0 || h->version != GOMOKU_SAMPLE_VERSION
+        || h->sampleBytes != GOMOKU_SAMPLE_BYTES) {
+        gomoku_sample_shard_close(s);
+        return NULL;
+    }
+    return s;
+}
+
+void gomoku_sample_shard_close(GomokuSampleShard* shard) {
+    if (!shard) return;
+    mapped_file_close(&shard->file);
+    delete shard;
+}
+
+const GomokuSampleHeader* gomoku_sample_shard_header(const GomokuSampleShard* shard) {
+    return (const GomokuSampleHeader*)shard->file.data;
+}
+
+uint64_t gomoku_sample_shard_count(const GomokuSampleShard* shard) {
+    return (shard->file.size - sizeof(GomokuSampleHeader)) / sizeof(GomokuSample);
+}
+
+const GomokuSample* gomoku_sample_shard_samples(const GomokuSampleShard* shard) {
+    return (const GomokuSample*)(shard->file.data + sizeof(GomokuSampleHeader));
+}
@@ -0,0 +1,106 @@
+#pragma once
+#ifndef GOMOKU_SAMPLES_H
+#define GOMOKU_SAMPLES_H
+#include "gomoku_logic.h"
+
+/// 一条训练样本的字节数，所有棋盘尺寸相同
+#define GOMOKU_SAMPLE_BYTES 112
+
+/// 样本分片文件头的字节数
+#define GOMOKU_SAMPLE_HEADER_BYTES 32
+
+/// 分片文件头的魔数（8 字节，含结尾的 '\0'）与版本
+#define GOMOKU_SAMPLE_MAGIC "GMKSMP1"
+#define GOMOKU_SAMPLE_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/**
+	 * 一条训练样本：某局面、轮走方、在该局面上搜索得到的分数与着法、以及这局棋的最终结果。
+	 * 定长 GOMOKU_SAMPLE_BYTES 字节，小端，可以直接按数组内存映射。
+	 * 盘面按格子编号 r * size + c 压成两个位平面：stones[0] 为 'X'，stones[1] 为 'O'，第 i 格在第 i / 8 字节的第 i % 8 位。
+	 */
+	typedef struct GomokuSample {
+		uint8_t stones[2][(GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE + 7) / 8];
+		int32_t score;       // 搜索分数，从轮走方的角度计算（见 GomokuAiStats::score）
+		uint16_t ply;        // 局面之前已下的手数
+		uint8_t sideToMove;  // 0 为 'X'，1 为 'O'
+		int8_t result;       // 最终结果，从轮走方看：1 胜、0 和、-1 负
+		uint8_t row, col;    // 搜索选出的着法
+		uint8_t reserved[2];
+	} GomokuSample;
+
+	/**
+	 * 样本分片文件的文件头，之后紧跟若干条 GomokuSample。文件头不记条数：条数为 (文件字节数 - 文件头) / GOMOKU_SAMPLE_BYTES，
+	 * 因此写到一半的分片也能边写边读，末尾写了一半的样本被忽略。
+	 */
+	typedef struct GomokuSampleHeader {
+		char magic[8];
+		uint32_t version;
+		uint32_t sampleBytes;  // GOMOKU_SAMPLE_BYTES
+		uint8_t size;          // 棋盘尺寸
+		uint8_t rule;          // GomokuRule
+		uint8_t reserved[2];
+		uint32_t shard;        // 分片编号
+		uint64_t seed;         // 生成时的随机种子
+	} GomokuSampleHeader;
+
+	/// 样本分片的写入句柄，见 gomoku_sample_writer_open()
+	typedef struct GomokuSampleWriter GomokuSampleWriter;
+
+	/// 内存映射的样本分片，见 gomoku_sample_shard_open()
+	typedef struct GomokuSampleShard GomokuSampleShard;
+
+	/**
+	 * 把 g 的当前局面与搜索结果打包成一条样本（result 先填 0，整局结束后由调用方回填）。
+	 */
+	void gomoku_sample_pack(const GomokuGame* g, int score, int row, int col, GomokuSample* sample);
+
+	/**
+	 * 在 size 路、rule 规则下把样本的盘面恢复到 g：'X' 与 'O' 的棋子交替落下（顺序不是原局的顺序）。
+	 * 双方子数与轮走方不符合交替落子（轮到 'X' 时子数相等，轮到 'O' 时 'X' 多一个）时返回 false。
+	 */
+	bool gomoku_sample_unpack(const GomokuSample* sample, int size, GomokuRule rule, GomokuGame* g);
+
+	/**
+	 * 把 size 路棋盘上的样本按对称变换 symmetry（编号见 gomoku_symmetry_map()）变换到 *out：盘面与着法一起变换，其余字段不变。
+	 * 可用来把样本换成规范朝向（配合 gomoku_game_canonical_hash()），或把一条样本扩增成 8 条。sample 与 out 可以相同。
+	 */
+	void gomoku_sample_transform(const GomokuSample* sample, int size, int symmetry, GomokuSample* out);
+
+	/**
+	 * 新建（覆盖）分片文件并写入文件头。失败时返回 NULL。
+	 */
+	GomokuSampleWriter* gomoku_sample_writer_open(const char* filename, int size, GomokuRule rule, uint32_t shard, uint64_t seed);
+
+	/**
+	 * 追加 count 条样本（经过 stdio 缓冲）。返回 false 表示写入失败。
+	 */
+	bool gomoku_sample_writer_add(GomokuSampleWriter* writer, const GomokuSample* samples, int count);
+
+	/**
+	 * 写出缓冲、落盘并关闭。返回 false 表示写入失败。传入 NULL 时返回 true。
+	 */
+	bool gomoku_sample_writer_close(GomokuSampleWriter* writer);
+
+	/**
+	 * 映射一个分片文件；文件头不符时返回 NULL。
+	 */
+	GomokuSampleShard* gomoku_sample_shard_open(const char* filename);
+
+	void gomoku_sample_shard_close(GomokuSampleShard* shard);
+
+	/**
+	 * 分片的文件头与样本。样本数组直接指向映射的文件，关闭后失效。
+	 */
+	const GomokuSampleHeader* gomoku_sample_shard_header(const GomokuSampleShard* shard);
+	uint64_t gomoku_sample_shard_count(const GomokuSampleShard* shard);
+	const GomokuSample* gomoku_sample_shard_samples(const GomokuSampleShard* shard);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GOMOKU_SAMPLES_H
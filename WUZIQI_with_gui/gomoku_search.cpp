@@ -0,0 +1,101 @@
+#include "gomoku_ai.h"
+#include "gomoku_board.h"
+#include "gomoku_search.h"
+#include <new>
+#include <thread>
+
+// 异步搜索：句柄持有局面副本与控制块，在一个后台线程里跑同步搜索（其余搜索线程由引擎自己开）。
+// 取消只是置控制块的停止标志，搜索线程几毫秒内就会收尾并给出到目前为止的最佳着法。
+
+struct GomokuSearch {
+    GomokuGame* game;
+    GomokuSearchLimits limits;
+    SearchControl control;
+    std::thread thread;
+    std::atomic<bool> done;
+    bool found;
+    int row, col;
+    GomokuAiStats stats;
+};
+
+// 按 limits 选择引擎，在当前线程里同步搜索；MCTS 的统计折算成 GomokuAiStats
+static bool search_run(const GomokuGame* g, const GomokuSearchLimits* limits, SearchControl* control,
+    int* row, int* col, GomokuAiStats* stats) {
+    if (limits->engine != GOMOKU_ENGINE_MCTS) return ai_search_run(g, limits->maxDepth, control, row, col, stats);
+    GomokuMctsStats m = {};
+    bool found = mcts_search_run(g, control, row, col, &m);
+    stats->nodes = m.playouts;
+    stats->timeMs = m.timeMs;
+    stats->nodesPerSecond = m.playoutsPerSecond;
+    stats->threads = m.threads;
+    stats->bookMove = m.bookMove;
+    return found;
+}
+
+static void search_thread_main(GomokuSearch* s) {
+    s->found = search_run(s->game, &s->limits, &s->control, &s->row, &s->col, &s->stats);
+    s->done.store(true, std::memory_order_release);
+}
+
+bool gomoku_game_search(const GomokuGame* g, const GomokuSearchLimits* limits, int* row, int* col, GomokuAiStats* stats) {
+    SearchControl control;
+    search_control_init(&control, limits, NULL, NULL);
+    GomokuAiStats st = {};
+    int r = -1, c = -1;
+    bool found = search_run(g, limits, &control, &r, &c, &st);
+    if (found) {
+        *row = r;
+        *col = c;
+    }
+    if (stats) *stats = st;
+    return found;
+}
+
+GomokuSearch* gomoku_search_start(const GomokuGame* g, const GomokuSearchLimits* limits, GomokuProgressCallback callback, void* userData) {
+    GomokuSearch* s = new (std::nothrow) GomokuSearch();
+    if (!s) return NULL;
+    s->game = gomoku_game_create_variant(g->size, g->rule);
+    if (!s->game) {
+        delete s;
+        return NULL;
+    }
+    memcpy(s->game, g, sizeof(GomokuGame));
+    s->limits = *limits;
+    s->done = false;
+    s->found = false;
+    s->row = s->col = -1;
+    search_control_init(&s->control, limits, callback, userData);
+    s->thread = std::thread(search_thread_main, s);
+    return s;
+}
+
+void gomoku_search_poll(GomokuSearch* search, GomokuSearchProgress* progress) {
+    std::lock_guard<std::mutex> lock(search->control.mutex);
+    *progress = search->control.progress;
+}
+
+bool gomoku_search_done(const GomokuSearch* search) {
+    return search->done.load(std::memory_order_acquire);
+}
+
+void gomoku_search_stop(GomokuSearch* search) {
+    search->control.stop.store(true, std::memory_order_relaxed);
+}
+
+bool gomoku_search_wait(GomokuSearch* search, int* row, int* col, GomokuAiStats* stats) {
+    if (search->thread.joinable()) search->thread.join();
+    if (search->found) {
+        *row = search->row;
+        *col = search->col;
+    }
+    if (stats) *stats = search->stats;
+    return search->found;
+}
+
+void gomoku_search_destroy(GomokuSearch* search) {
+    if (!search) return;
+    gomoku_search_stop(search);
+    if (search->thread.joinable()) search->thread.join();
+    gomoku_game_destroy(search->game);
+    delete search;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#ifndef GOMOKU_SEARCH_H
+#define GOMOKU_SEARCH_H
+#include "gomoku_ai.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string.h>
+
+// 一次搜索的控制块（搜索内部使用），同步接口与异步接口共用：
+// 停止标志（外部取消、时间或节点预算用完时置位）、所有线程合计的节点数、进度快照与回调。
+// 各搜索线程每隔一段节点把本地计数累加到 nodes 并检查预算；只有主线程看时间、发进度。
+
+typedef std::chrono::steady_clock SearchClock;
+
+struct SearchControl {
+    std::atomic<bool> stop;
+    std::atomic<uint64_t> nodes;
+    uint64_t maxNodes;            // 0 表示不限
+    bool timed;
+    SearchClock::time_point start;
+    SearchClock::time_point deadline;
+    int reportMs;                 // 定时进度回调的间隔
+    SearchClock::time_point nextReport;
+    GomokuProgressCallback callback;
+    void* userData;
+    std::mutex mutex;             // 保护 progress
+    GomokuSearchProgress progress;
+};
+
+// 按限制初始化控制块；timeMs <= 0 表示不限时间
+static inline void search_control_init(SearchControl* c, const GomokuSearchLimits* limits,
+    GomokuProgressCallback callback, void* userData) {
+    c->stop = false;
+    c->nodes = 0;
+    c->maxNodes = limits->maxNodes;
+    c->timed = limits->timeMs > 0;
+    c->start = SearchClock::now();
+    c->deadline = c->start + std::chrono::milliseconds(c->timed ? limits->timeMs : 0);
+    c->reportMs = limits->reportMs > 0 ? limits->reportMs : GOMOKU_SEARCH_DEFAULT_REPORT_MS;
+    c->nextReport = c->start + std::chrono::milliseconds(c->reportMs);
+    c->callback = callback;
+    c->userData = userData;
+    memset(&c->progress, 0, sizeof(c->progress));
+    c->progress.row = c->progress.col = -1;
+}
+
+static inline int search_elapsed_ms(const SearchControl* c) {
+    return (int)std::chrono::duration_cast<std::chrono::milliseconds>(SearchClock::now() - c->start).count();
+}
+
+// 把本地新增的节点数累加到合计并检查节点预算；返回是否应当停止
+static inline bool search_add_nodes(SearchControl* c, uint64_t delta) {
+    uint64_t total = c->nodes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (c->maxNodes && total >= c->maxNodes) c->stop.store(true, std::memory_order_relaxed);
+    return c->stop.load(std::memory_order_relaxed);
+}
+
+// 主线程：时间用完时置停止标志；返回是否应当停止
+static inline bool search_check_time(SearchControl* c) {
+    if (c->timed && SearchClock::now() >= c->deadline) c->stop.store(true, std::memory_order_relaxed);
+    return c->stop.load(std::memory_order_relaxed);
+}
+
+// 主线程：距上次回调已超过 reportMs 时返回 true 并推迟下一次
+static inline bool search_report_due(SearchControl* c) {
+    SearchClock::time_point now = SearchClock::now();
+    if (now < c->nextReport) return false;
+    c->nextReport = now + std::chrono::milliseconds(c->reportMs);
+    return true;
+}
+
+// 填上用时、节点数与速度后保存进度快照并回调（回调在搜索线程中执行）
+static inline void search_publish(SearchControl* c, GomokuSearchProgress* p) {
+    p->timeMs = search_elapsed_ms(c);
+    p->nodes = c->nodes.load(std::memory_order_relaxed);
+    p->nodesPerSecond = p->nodes * 1000 / (uint64_t)(p->timeMs > 0 ? p->timeMs : 1);
+    {
+        std::lock_guard<std::mutex> lock(c->mutex);
+        c->progress = *p;
+    }
+    if (c->callback) c->callback(p, c->userData);
+}
+
+// 两种引擎在控制块下的搜索，stats 可为 NULL；定义见 gomoku_ai.cpp 与 gomoku_mcts.cpp
+bool ai_search_run(const GomokuGame* g, int maxDepth, SearchControl* control, int* row, int* col, GomokuAiStats* stats);
+bool mcts_search_run(const GomokuGame* g, SearchControl* control, int* row, int* col, GomokuMctsStats* stats);
+
+// AI 使用的开局库里有 g 的着法时写入 *row、*col 与得分率 *score，发出最终进度并返回 true；定义见 gomoku_book.cpp
+bool book_search_move(const GomokuGame* g, SearchControl* control, int* row, int* col, double* score);
+
+#endif // GOMOKU_SEARCH_H
@@ -0,0 +1,138 @@
+#pragma once
+#ifndef GOMOKU_SYMMETRY_H
+#define GOMOKU_SYMMETRY_H
+#include "gomoku_board.h"
+
+// 棋盘的 8 种对称变换（二面体群 D4，逻辑层内部使用）：0 恒等，1..3 顺时针旋转 90/180/270 度，
+// 4 左右翻转，5 上下翻转，6 沿主对角线翻转，7 沿副对角线翻转。
+// 规范形取按行比较最小的朝向，在位棋盘上整块做变换；gomoku_canonical_hash() 与棋谱库、开局库的键
+// 都由 symmetry_canonical_hash() 得出，互相对称的局面得到同一个值。
+
+#define SYMMETRY_COUNT 8
+
+// 变换 s 拆成 先沿主对角线转置、再上下翻转、再左右翻转 三步，按位记录（位 0 转置，位 1 上下，位 2 左右）
+static const unsigned char symmetry_steps[SYMMETRY_COUNT] = { 0, 5, 6, 3, 4, 2, 1, 7 };
+
+// 逆变换：两个方向的旋转 90 度互逆，其余变换都是自身的逆
+static inline int symmetry_inverse(int s) {
+    return s == 1 ? 3 : (s == 3 ? 1 : s);
+}
+
+// 把 n 路棋盘上的 (r,c) 按变换 s 映射到 (*tr,*tc)
+static inline void symmetry_apply(int s, int n, int r, int c, int* tr, int* tc) {
+    int m = n - 1;
+    switch (s) {
+    case 0: *tr = r; *tc = c; break;
+    case 1: *tr = c; *tc = m - r; break;
+    case 2: *tr = m - r; *tc = m - c; break;
+    case 3: *tr = m - c; *tc = r; break;
+    case 4: *tr = r; *tc = m - c; break;
+    case 5: *tr = m - r; *tc = c; break;
+    case 6: *tr = c; *tc = r; break;
+    default: *tr = m - c; *tc = m - r; break;
+    }
+}
+
+// 位棋盘：rows[p][r] 的第 c 位表示 p 方在 (r,c) 有子（不含 LINE_PAD），第 n 行、第 n 位起都为 0。
+// 按 32 行分配，转置时可以直接当作 32×32 的位矩阵。
+struct SymmetryBoard {
+    uint32_t rows[2][32];
+};
+
+// 32 位反转：相邻 1、2、4、8、16 位依次互换
+static inline uint32_t symmetry_reverse_bits(uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+// 32×32 位矩阵原地转置（第 r 行第 c 位与第 c 行第 r 位互换）：按 16、8、4、2、1 的块大小，
+// 交换每对行中左下块与右上块，共 5 × 16 次掩码异或
+static inline void symmetry_transpose(uint32_t a[32]) {
+    uint32_t m = 0x0000FFFFu;
+    for (int j = 16; j != 0; j >>= 1, m ^= m << j) {
+        for (int k = 0; k < 32; k = (k + j + 1) & ~j) {
+            uint32_t t = ((a[k] >> j) ^ a[k + j]) & m;
+            a[k] ^= t << j;
+            a[k + j] ^= t;
+        }
+    }
+}
+
+// 按 steps 的位 1、位 2 做上下翻转（行序反转）与左右翻转（逐行位反转）后 p 方的第 r 行，不含转置
+static inline uint32_t symmetry_board_row(const SymmetryBoard* src, int n, int steps, int p, int r) {
+    uint32_t x = src->rows[p][steps & 2 ? n - 1 - r : r];
+    return steps & 4 ? symmetry_reverse_bits(x) >> (32 - n) : x;
+}
+
+static inline void symmetry_board_flip(const SymmetryBoard* src, int n, int steps, SymmetryBoard* dst) {
+    for (int p = 0; p < 2; p++) {
+        for (int r = 0; r < n; r++) dst->rows[p][r] = symmetry_board_row(src, n, steps, p, r);
+        for (int r = n; r < 32; r++) dst->rows[p][r] = 0;
+    }
+}
+
+// 把 n 路位棋盘按变换 s 整体变换到 dst（与 symmetry_apply() 逐格映射的结果相同）；src 与 dst 可以相同
+static inline void symmetry_board_transform(const SymmetryBoard* src, int n, int s, SymmetryBoard* dst) {
+    int steps = symmetry_steps[s];
+    SymmetryBoard t = *src;
+    if (steps & 1) {
+        symmetry_transpose(t.rows[0]);
+        symmetry_transpose(t.rows[1]);
+    }
+    symmetry_board_flip(&t, n, steps, dst);
+}
+
+// 把 src 翻转后的位棋盘与 best 按 'X' 的各行、再 'O' 的各行比较，返回是否更小；逐行边翻转边比较，分出大小即停
+static inline bool symmetry_board_less(const SymmetryBoard* src, int n, int steps, const SymmetryBoard* best) {
+    for (int p = 0; p < 2; p++) {
+        for (int r = 0; r < n; r++) {
+            uint32_t x = symmetry_board_row(src, n, steps, p, r);
+            if (x != best->rows[p][r]) return x < best->rows[p][r];
+        }
+    }
+    return false;
+}
+
+// 位棋盘的 Zobrist 哈希，与摆出同样盘面的棋局的 GomokuGame::hash 相同
+static inline uint64_t symmetry_board_hash(const SymmetryBoard* b, int n) {
+    uint64_t h = 0;
+    for (int p = 0; p < 2; p++) {
+        for (int r = 0; r < n; r++) {
+            for (uint32_t bits = b->rows[p][r]; bits; bits &= bits - 1) {
+                h ^= gomoku_zobrist_keys.key[p][board_cell_index(r, board_lowest_bit(bits))];
+            }
+        }
+    }
+    return h;
+}
+
+// 局面的一对位棋盘：pair[0] 是盘面本身，pair[1] 是它的转置（即列线），8 个朝向都由这两个做行序反转与逐行位反转得到。
+// 落子与撤销都是同一次异或
+static inline void symmetry_pair_toggle(SymmetryBoard pair[2], int p, int r, int c) {
+    pair[0].rows[p][r] ^= 1u << c;
+    pair[1].rows[p][c] ^= 1u << r;
+}
+// 规范哈希：各朝向先逐行与当前最小者比较，更小时才整块展开；返回规范形的 Zobrist 哈希，
+// symmetry 不为 NULL 时写入把局面变换成规范形的变换编号
+static inline uint64_t symmetry_canonical_hash(const SymmetryBoard pair[2], int n, int* symmetry) {
+    SymmetryBoard best;
+    int bestSymmetry = 0;
+    symmetry_board_flip(&pair[0], n, 0, &best);
+    for (int s = 1; s < SYMMETRY_COUNT; s++) {
+        int steps = symmetry_steps[s];
+        if (symmetry_board_less(&pair[steps & 1], n, steps, &best)) {
+            symmetry_board_flip(&pair[steps & 1], n, steps, &best);
+            bestSymmetry = s;
+        }
+    }
+    if (symmetry) *symmetry = bestSymmetry;
+    return symmetry_board_hash(&best, n);
+}
+// 局面的键：规范哈希再区分棋盘尺寸与规则（棋谱库与开局库共用）
+static inline uint64_t symmetry_position_key(uint64_t canonical, int size, int rule) {
+    return canonical ^ ((uint64_t)size * 0x9E3779B97F4A7C15ull) ^ ((uint64_t)(rule + 1) * 0xC2B2AE3D27D4EB4Full);
+}
+#endif // GOMOKU_SYMMETRY_H
@@ -0,0 +1,141 @@
+#pragma once
+#ifndef GOMOKU_TACTICS_H
+#define GOMOKU_TACTICS_H
+#include "gomoku_moves.h"
+
+// 搜索共用的着法生成与战术判断（搜索内部使用）：候选着法打分、成五点、禁手过滤。
+// 全部只读增量维护的线编码与威胁位，不扫描整盘棋子。
+
+#define AI_MAX_MOVES (GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE)
+
+struct AiMove {
+    int score;
+    unsigned char row, col;
+};
+
+// 单线棋形的着法分，顺序同 GomokuShape
+static const int aiShapeScore_internal[9] = { 0, 10, 25, 60, 80, 300, 1200, 2500, 100000 };
+
+// 一方在某空位四个方向上的棋形分：逐线累加，再按双四/活四、四三、双三加分
+static inline int ai_combo_score(const int shapes[LINE_DIRS]) {
+    int score = 0, fours = 0, threes = 0;
+    for (int d = 0; d < LINE_DIRS; d++) {
+        int s = shapes[d];
+        score += aiShapeScore_internal[s];
+        if (s == SHAPE_CLOSED_FOUR) fours++;
+        else if (s == SHAPE_DOUBLE_FOUR || s == SHAPE_OPEN_FOUR) fours += 2;
+        else if (s == SHAPE_SPLIT_THREE || s == SHAPE_OPEN_THREE) threes++;
+    }
+    if (fours >= 2) score += 5000;
+    else if (fours && threes) score += 3000;
+    else if (threes >= 2) score += 1500;
+    return score;
+}
+
+// 玩家 p 在空位 (r,c) 落子的着法分：己方进攻分略高于阻挡对方的分
+template <int N>
+static inline int ai_cell_score(const GomokuGame* g, int p, int r, int c) {
+    int shapes[2][LINE_DIRS];
+    for (int d = 0; d < LINE_DIRS; d++) {
+        int idx = board_line_index<N>(d, r, c);
+        uint8_t entry = pattern_lookup(g->lineBits[0][d][idx], g->lineBits[1][d][idx],
+            ~board_line_mask<N>(d, idx), board_line_pos(d, r, c));
+        shapes[0][d] = pattern_shape(entry, 0);
+        shapes[1][d] = pattern_shape(entry, 1);
+    }
+    int attack = ai_combo_score(shapes[p]);
+    return attack + attack / 4 + ai_combo_score(shapes[p ^ 1]);
+}
+
+// 玩家 p 在空位 (r,c) 落子后是否按规则成五（不改动棋局）
+template <int N, class Rule>
+static inline bool ai_makes_five(const GomokuGame* g, int p, int r, int c) {
+    for (int d = 0; d < LINE_DIRS; d++) {
+        int idx = board_line_index<N>(d, r, c);
+        int b = board_line_pos(d, r, c);
+        uint32_t run = board_run_through(g->lineBits[p][d][idx] | (1u << b), b);
+        int len = board_popcount(run);
+        if (len < 5) continue;
+        uint32_t ends = ((run << 1) | (run >> 1)) & ~run;
+        if (Rule::fiveWins(p, len, (ends & g->lineBits[p ^ 1][d][idx]) == ends)) return true;
+    }
+    return false;
+}
+
+// 玩家 p 的成五点，最多写入 cap 个。成五点一定在 p 的威胁位中，只需逐个核对
+template <int N, class Rule>
+static int ai_five_points(const GomokuGame* g, int p, AiMove* moves, int cap) {
+    int n = 0;
+    for (int r = 0; r < N; r++) {
+        uint32_t bits = g->threatRows[p][0][r] | g->threatRows[p][1][r] | g->threatRows[p][2][r] | g->threatRows[p][3][r];
+        for (; bits; bits &= bits - 1) {
+            int c = board_lowest_bit(bits);
+            if (!ai_makes_five<N, Rule>(g, p, r, c)) continue;
+            moves[n].score = 0;
+            moves[n].row = (unsigned char)r;
+            moves[n].col = (unsigned char)c;
+            if (++n == cap) return n;
+        }
+    }
+    return n;
+}
+
+// 去掉黑方的禁手点，返回剩余个数
+template <int N, class Rule>
+static int ai_remove_forbidden(const GomokuGame* g, int p, AiMove* moves, int n) {
+    if (!Rule::hasForbidden || p != 0) return n;
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        if (!renju_is_forbidden<N>(g, moves[i].row, moves[i].col)) moves[k++] = moves[i];
+    }
+    return k;
+}
+
+// 距棋子两格以内的空位（黑方去掉禁手点）并打分；空棋盘只下天元
+template <int N, class Rule>
+static int ai_generate(const GomokuGame* g, int p, AiMove* moves) {
+    if (g->moveCount == 0) {
+        moves[0].score = 0;
+        moves[0].row = moves[0].col = (unsigned char)(N / 2);
+        return 1;
+    }
+    int n = 0;
+    for (int r = 0; r < N; r++) {
+        uint32_t occupied = (g->lineBits[0][0][r] | g->lineBits[1][0][r]) >> LINE_PAD;
+        uint32_t forbid = Rule::hasForbidden && p == 0 ? renju_candidate_row(g, r) : 0;
+        for (uint32_t bits = g->nearRows[1][r] & ~occupied; bits; bits &= bits - 1) {
+            int c = board_lowest_bit(bits);
+            if (((forbid >> c) & 1u) && renju_is_forbidden<N>(g, r, c)) continue;
+            moves[n].score = ai_cell_score<N>(g, p, r, c);
+            moves[n].row = (unsigned char)r;
+            moves[n].col = (unsigned char)c;
+            n++;
+        }
+    }
+    return n;
+}
+
+static inline int ai_move_code(const AiMove& m) {
+    return m.row * GOMOKU_MAX_SIZE + m.col;
+}
+
+// 把 moves[i..n) 中分数最高的一手换到第 i 位
+static inline void ai_pick_move(AiMove* moves, int i, int n) {
+    int best = i;
+    for (int k = i + 1; k < n; k++) {
+        if (moves[k].score > moves[best].score) best = k;
+    }
+    if (best != i) {
+        AiMove t = moves[i];
+        moves[i] = moves[best];
+        moves[best] = t;
+    }
+}
+
+template <int N, class Rule>
+static inline void ai_play(GomokuGame* g, const AiMove& m) {
+    board_do_move<N, Rule>(g, m.row, m.col);
+    g->currentPlayer = g->currentPlayer == 'X' ? 'O' : 'X';
+}
+
+#endif // GOMOKU_TACTICS_H
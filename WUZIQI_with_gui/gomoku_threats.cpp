@@ -0,0 +1,60 @@
+#include "gomoku_ai.h"
+#include "gomoku_threats.h"
+#include <vector>
+
+// 威胁空间搜索的公共接口：在局面副本上求解，VCT 模式先用同一份预算找 VCF。
+
+static_assert(THREAT_MAX_PLY == GOMOKU_THREAT_MAX_MOVES, "threat sequence length mismatch");
+
+template <int N, class Rule>
+static bool threat_search_internal(const GomokuGame* src, GomokuThreatMode mode, uint64_t maxNodes, int timeMs, GomokuThreatResult* result) {
+    ThreatClock::time_point start = ThreatClock::now();
+    memset(result, 0, sizeof(*result));
+    GomokuGame* g = gomoku_game_create_variant(src->size, src->rule);
+    if (!g) {
+        result->status = GOMOKU_THREAT_UNKNOWN;
+        return false;
+    }
+    memcpy(g, src, sizeof(GomokuGame));
+    std::vector<uint64_t> cache(THREAT_CACHE_SIZE);
+    ThreatContext t;
+    t.game = g;
+    t.attacker = board_player_index(g->currentPlayer);
+    t.nodes = 0;
+    t.maxNodes = maxNodes;
+    t.timed = timeMs > 0;
+    t.deadline = start + std::chrono::milliseconds(timeMs > 0 ? timeMs : 0);
+    t.cancel = NULL;
+    t.stopped = false;
+    t.cache = cache.data();
+    t.vct = false;
+    int found = threat_solve<N, Rule>(&t, THREAT_VCF_DEPTH);
+    if (found == 0 && mode == GOMOKU_THREAT_VCT) {
+        memset(t.cache, 0, THREAT_CACHE_SIZE * sizeof(uint64_t));
+        t.vct = true;
+        found = threat_solve<N, Rule>(&t, THREAT_VCT_DEPTH);
+    }
+    result->status = found > 0 ? GOMOKU_THREAT_WIN : (found < 0 ? GOMOKU_THREAT_UNKNOWN : GOMOKU_THREAT_NONE);
+    if (found > 0) {
+        result->length = t.pvLength[0];
+        for (int i = 0; i < result->length; i++) {
+            result->moves[i][0] = t.pv[0][i] / GOMOKU_MAX_SIZE;
+            result->moves[i][1] = t.pv[0][i] % GOMOKU_MAX_SIZE;
+        }
+    }
+    result->nodes = t.nodes;
+    result->timeMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(ThreatClock::now() - start).count();
+    gomoku_game_destroy(g);
+    return found > 0;
+}
+
+bool gomoku_game_threat_search(const GomokuGame* g, GomokuThreatMode mode, uint64_t maxNodes, int timeMs, GomokuThreatResult* result) {
+    GOMOKU_DISPATCH(g, threat_search_internal, g, mode, maxNodes, timeMs, result);
+}
+
+
+// ----------------- 默认实例上的全局接口 -----------------
+
+bool gomoku_threat_search(GomokuThreatMode mode, uint64_t maxNodes, int timeMs, GomokuThreatResult* result) {
+    return gomoku_game_threat_search(gomoku_default_game(), mode, maxNodes, timeMs, result);
+}
@@ -0,0 +1,254 @@
+#pragma once
+#ifndef GOMOKU_THREATS_H
+#define GOMOKU_THREATS_H
+#include "gomoku_tactics.h"
+#include <atomic>
+#include <chrono>
+
+// 威胁空间搜索（搜索内部使用）：只让进攻方走冲四（VCF）或冲四与活三（VCT），防守方只走必要的应手。
+// 进攻方冲四后防守方只能堵唯一的成五点；进攻方做活三后，防守方的应手限定为
+// 进攻方下一手能成活四/双四的点所在线段（左右各 4 格）上的空位，再加上防守方自己的冲四（反击）。
+// 不在这些线段上又不冲四的应手挡不住下一手的活四，因此剪掉它们不会把非必胜误判为必胜。
+// 防守方冲四反击时进攻方必须先堵，堵完仍轮到防守方应对原来的威胁，两种节点因此都按局面而不是按上一手判断。
+// 进攻深度按进攻方的手数迭代加深，找到的是（在预算内）最短的必胜序列；
+// 已证明在某一剩余深度下不能取胜的局面记入失败缓存，同一次求解中不再重复展开。
+
+#define THREAT_MAX_PLY 72
+#define THREAT_VCF_DEPTH 32        // VCF 进攻方最多的手数
+#define THREAT_VCT_DEPTH 12        // VCT 进攻方最多的手数
+#define THREAT_CACHE_SIZE (1 << 16)
+#define THREAT_CHECK_NODES 255
+
+// 进攻着法的排序加分：冲四总在活三之前
+#define THREAT_FOUR_BONUS (1 << 20)
+
+typedef std::chrono::steady_clock ThreatClock;
+
+struct ThreatContext {
+    GomokuGame* game;
+    int attacker;               // 进攻方的玩家下标
+    bool vct;                   // false 只走冲四（VCF），true 还可以走活三（VCT）
+    uint64_t nodes;
+    uint64_t maxNodes;          // 0 表示不限
+    bool timed;
+    ThreatClock::time_point deadline;
+    const std::atomic<bool>* cancel;  // 外部取消标志，可为 NULL
+    bool stopped;               // 预算用完或被取消，结果未知
+    uint64_t* cache;            // 失败缓存，可为 NULL；每项为 哈希高位 | 剩余深度
+    // 三角形主变例：pv[ply] 保存从第 ply 层开始的必胜序列，着法编码为 r * GOMOKU_MAX_SIZE + c
+    unsigned short pv[THREAT_MAX_PLY][THREAT_MAX_PLY];
+    int pvLength[THREAT_MAX_PLY];
+};
+
+static inline bool threat_out_of_budget(ThreatContext* t) {
+    ++t->nodes;
+    if (t->maxNodes && t->nodes >= t->maxNodes) t->stopped = true;
+    else if ((t->nodes & THREAT_CHECK_NODES) == 0
+        && ((t->cancel && t->cancel->load(std::memory_order_relaxed)) || (t->timed && ThreatClock::now() >= t->deadline))) {
+        t->stopped = true;
+    }
+    return t->stopped;
+}
+
+// 第 ply 层的序列 = move + 第 ply+1 层的序列
+static inline void threat_set_pv(ThreatContext* t, int ply, int move) {
+    t->pv[ply][0] = (unsigned short)move;
+    int n = ply + 1 < THREAT_MAX_PLY ? t->pvLength[ply + 1] : 0;
+    if (n > THREAT_MAX_PLY - 1) n = THREAT_MAX_PLY - 1;
+    memcpy(&t->pv[ply][1], t->pv[ply + 1], n * sizeof(unsigned short));
+    t->pvLength[ply] = n + 1;
+}
+
+static inline bool threat_cache_failed(const ThreatContext* t, int depth) {
+    if (!t->cache) return false;
+    uint64_t e = t->cache[t->game->hash & (THREAT_CACHE_SIZE - 1)];
+    return (e & ~63ull) == (t->game->hash & ~63ull) && (int)(e & 63) >= depth;
+}
+
+static inline void threat_cache_store(ThreatContext* t, int depth) {
+    if (t->cache) t->cache[t->game->hash & (THREAT_CACHE_SIZE - 1)] = (t->game->hash & ~63ull) | (uint64_t)depth;
+}
+
+// 玩家 p 在空位 (r,c) 落子后各方向的棋形
+template <int N>
+static inline void threat_shapes(const GomokuGame* g, int p, int r, int c, int shapes[LINE_DIRS]) {
+    for (int d = 0; d < LINE_DIRS; d++) {
+        int idx = board_line_index<N>(d, r, c);
+        uint8_t entry = pattern_lookup(g->lineBits[0][d][idx], g->lineBits[1][d][idx],
+            ~board_line_mask<N>(d, idx), board_line_pos(d, r, c));
+        shapes[d] = pattern_shape(entry, p);
+    }
+}
+
+// 玩家 p 的进攻着法：冲四，vct 时再加上活三；黑方去掉禁手点。返回个数
+template <int N, class Rule>
+static int threat_generate(const GomokuGame* g, int p, bool vct, AiMove* moves) {
+    int n = 0;
+    for (int r = 0; r < N; r++) {
+        uint32_t occupied = (g->lineBits[0][0][r] | g->lineBits[1][0][r]) >> LINE_PAD;
+        uint32_t forbid = Rule::hasForbidden && p == 0 ? renju_candidate_row(g, r) : 0;
+        for (uint32_t bits = g->nearRows[1][r] & ~occupied; bits; bits &= bits - 1) {
+            int c = board_lowest_bit(bits);
+            int shapes[LINE_DIRS];
+            threat_shapes<N>(g, p, r, c, shapes);
+            bool four = false, three = false;
+            for (int d = 0; d < LINE_DIRS; d++) {
+                if (shapes[d] >= SHAPE_CLOSED_FOUR) four = true;
+                else if (shapes[d] == SHAPE_SPLIT_THREE || shapes[d] == SHAPE_OPEN_THREE) three = true;
+            }
+            if (!four && !(vct && three)) continue;
+            if (((forbid >> c) & 1u) && renju_is_forbidden<N>(g, r, c)) continue;
+            moves[n].score = ai_cell_score<N>(g, p, r, c) + (four ? THREAT_FOUR_BONUS : 0);
+            moves[n].row = (unsigned char)r;
+            moves[n].col = (unsigned char)c;
+            n++;
+        }
+    }
+    return n;
+}
+
+// 进攻方已做成活三时防守方的应手，写入 moves 并返回个数；返回 0 表示进攻方并没有活四/双四的威胁。
+// 威胁点取进攻方威胁位中落子后确实有两个成五点的空位（黑方去掉禁手点），应手为这些点所在线段上的空位，
+// 再加上防守方的冲四；黑方防守时去掉禁手点
+template <int N, class Rule>
+static int threat_defences(GomokuGame* g, int a, AiMove* moves) {
+    uint32_t mark[GOMOKU_MAX_SIZE] = {};
+    bool threatened = false;
+    AiMove fives[2];
+    for (int r = 0; r < N; r++) {
+        for (uint32_t bits = g->threatRows[a][0][r] | g->threatRows[a][1][r] | g->threatRows[a][2][r] | g->threatRows[a][3][r];
+            bits; bits &= bits - 1) {
+            int c = board_lowest_bit(bits);
+            if (Rule::hasForbidden && a == 0 && renju_is_forbidden<N>(g, r, c)) continue;
+            // 轮到防守方走棋，试下进攻方的棋子时临时换成进攻方
+            char side = g->currentPlayer;
+            g->currentPlayer = a == 0 ? 'X' : 'O';
+            board_do_move<N, Rule>(g, r, c);
+            bool real = ai_five_points<N, Rule>(g, a, fives, 2) >= 2;
+            board_undo_move<N>(g);
+            g->currentPlayer = side;
+            if (!real) continue;
+            threatened = true;
+            for (int d = 0; d < LINE_DIRS; d++) {
+                if (!((g->threatRows[a][d][r] >> c) & 1u)) continue;
+                int idx = board_line_index<N>(d, r, c);
+                int b = board_line_pos(d, r, c);
+                uint32_t window = ((1u << 9) - 1) << (b - 4);
+                uint32_t empty = window & board_line_mask<N>(d, idx) & ~(g->lineBits[0][d][idx] | g->lineBits[1][d][idx]);
+                for (; empty; empty &= empty - 1) {
+                    int rr, cc;
+                    board_line_cell<N>(d, idx, board_lowest_bit(empty), &rr, &cc);
+                    mark[rr] |= 1u << cc;
+                }
+            }
+        }
+    }
+    if (!threatened) return 0;
+    int n = 0, p = a ^ 1;
+    for (int r = 0; r < N; r++) {
+        uint32_t occupied = (g->lineBits[0][0][r] | g->lineBits[1][0][r]) >> LINE_PAD;
+        for (uint32_t bits = (mark[r] | g->nearRows[1][r]) & ~occupied; bits; bits &= bits - 1) {
+            int c = board_lowest_bit(bits);
+            if (!((mark[r] >> c) & 1u)) {
+                int shapes[LINE_DIRS];
+                threat_shapes<N>(g, p, r, c, shapes);
+                bool four = false;
+                for (int d = 0; d < LINE_DIRS; d++) four |= shapes[d] >= SHAPE_CLOSED_FOUR;
+                if (!four) continue;
+            }
+            if (Rule::hasForbidden && p == 0 && renju_is_forbidden<N>(g, r, c)) continue;
+            moves[n].score = ai_cell_score<N>(g, p, r, c);
+            moves[n].row = (unsigned char)r;
+            moves[n].col = (unsigned char)c;
+            n++;
+        }
+    }
+    // 黑方的应手全是禁手时也返回 0，按没有威胁处理（保守，不会误判必胜）
+    return n;
+}
+
+template <int N, class Rule>
+static bool threat_defend(ThreatContext* t, int depth, int ply);
+
+// 进攻方走棋：还剩 depth 手进攻时能否取胜；取胜时 pv[ply] 为必胜序列
+template <int N, class Rule>
+static bool threat_attack(ThreatContext* t, int depth, int ply) {
+    if (threat_out_of_budget(t)) return false;
+    GomokuGame* g = t->game;
+    int a = t->attacker;
+    AiMove moves[AI_MAX_MOVES];
+    t->pvLength[ply] = 0;
+    if (ai_five_points<N, Rule>(g, a, moves, 1)) {
+        t->pvLength[ply + 1] = 0;
+        threat_set_pv(t, ply, ai_move_code(moves[0]));
+        return true;
+    }
+    if (depth <= 0 || ply + 2 >= THREAT_MAX_PLY || threat_cache_failed(t, depth)) return false;
+    // 防守方冲四反击时只能去堵；堵点是禁手时已经输了
+    int n = ai_five_points<N, Rule>(g, a ^ 1, moves, 2);
+    if (n >= 2) return false;
+    if (n == 1) n = ai_remove_forbidden<N, Rule>(g, a, moves, 1);
+    else n = threat_generate<N, Rule>(g, a, t->vct, moves);
+    for (int i = 0; i < n; i++) {
+        ai_pick_move(moves, i, n);
+        ai_play<N, Rule>(g, moves[i]);
+        bool win = threat_defend<N, Rule>(t, depth - 1, ply + 1);
+        board_undo_move<N>(g);
+        if (t->stopped) return false;
+        if (win) {
+            threat_set_pv(t, ply, ai_move_code(moves[i]));
+            return true;
+        }
+    }
+    threat_cache_store(t, depth);
+    return false;
+}
+
+// 防守方走棋：是否所有应手都挡不住；挡不住时 pv[ply] 为第一个（最像样的）应手之后的必胜序列
+template <int N, class Rule>
+static bool threat_defend(ThreatContext* t, int depth, int ply) {
+    if (threat_out_of_budget(t)) return false;
+    GomokuGame* g = t->game;
+    int a = t->attacker, p = a ^ 1;
+    AiMove moves[AI_MAX_MOVES];
+    t->pvLength[ply] = 0;
+    if (ai_five_points<N, Rule>(g, p, moves, 1)) return false;
+    int n = ai_five_points<N, Rule>(g, a, moves, 2);
+    if (n >= 2) {
+        // 活四或双四：堵一个，进攻方在另一个成五
+        t->pv[ply][0] = (unsigned short)ai_move_code(moves[0]);
+        t->pv[ply][1] = (unsigned short)ai_move_code(moves[1]);
+        t->pvLength[ply] = 2;
+        return true;
+    }
+    if (n == 1) {
+        if (ai_remove_forbidden<N, Rule>(g, p, moves, 1) == 0) return true;
+    }
+    else {
+        if (!t->vct) return false;
+        n = threat_defences<N, Rule>(g, a, moves);
+        if (n == 0) return false;
+    }
+    for (int i = 0; i < n; i++) {
+        ai_pick_move(moves, i, n);
+        ai_play<N, Rule>(g, moves[i]);
+        bool win = threat_attack<N, Rule>(t, depth, ply + 1);
+        board_undo_move<N>(g);
+        if (!win) return false;
+        if (i == 0) threat_set_pv(t, ply, ai_move_code(moves[i]));
+    }
+    return true;
+}
+
+// 对 t->game 当前走棋方（即 t->attacker）求解：按进攻手数 1..maxDepth 迭代加深。
+// 返回 1 表示找到必胜序列（pv[0]），0 表示在该深度内没有，-1 表示预算用完
+template <int N, class Rule>
+static int threat_solve(ThreatContext* t, int maxDepth) {
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        if (threat_attack<N, Rule>(t, depth, 0)) return 1;
+        if (t->stopped) return -1;
+    }
+    return 0;
+}
+
+#endif // GOMOKU_THREATS_H
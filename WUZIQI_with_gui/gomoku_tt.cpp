@@ -0,0 +1,127 @@
+#include "gomoku_tt.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#define HUGE_PAGE_BYTES ((size_t)2 << 20)
+#endif
+
+// 大页分配：Windows 需要“锁定内存页”权限（SeLockMemoryPrivilege），大小按大页对齐；
+// Linux 在大小是 2MB 大页整数倍时先试 MAP_HUGETLB（需要预留大页；不是整数倍时内核会把映射向上取整，
+// 按原大小 munmap 会失败），不行再用普通页并建议内核使用透明大页。
+// 大页分配失败时退回普通页，hugePages 记录实际用的是哪一种。
+
+#ifdef _WIN32
+static bool enable_lock_memory_privilege_internal(void) {
+    HANDLE token;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) return false;
+    TOKEN_PRIVILEGES tp;
+    tp.PrivilegeCount = 1;
+    tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    bool ok = LookupPrivilegeValueA(NULL, "SeLockMemoryPrivilege", &tp.Privileges[0].Luid)
+        && AdjustTokenPrivileges(token, FALSE, &tp, 0, NULL, NULL)
+        && GetLastError() == ERROR_SUCCESS;
+    CloseHandle(token);
+    return ok;
+}
+#endif
+
+static void* alloc_pages_internal(size_t bytes, bool* huge) {
+    *huge = false;
+#ifdef _WIN32
+    SIZE_T large = GetLargePageMinimum();
+    if (large && bytes % large == 0 && enable_lock_memory_privilege_internal()) {
+        void* p = VirtualAlloc(NULL, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (p) {
+            *huge = true;
+            return p;
+        }
+    }
+    return VirtualAlloc(NULL, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    void* p;
+#ifdef MAP_HUGETLB
+    if (bytes % HUGE_PAGE_BYTES == 0) {
+        p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            *huge = true;
+            return p;
+        }
+    }
+#endif
+    p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+    madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    return p;
+#endif
+}
+
+static void free_pages_internal(void* p, size_t bytes) {
+#ifdef _WIN32
+    (void)bytes;
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    munmap(p, bytes);
+#endif
+}
+
+
+bool tt_resize(TranspositionTable* tt, size_t megabytes) {
+    if (megabytes < 1) megabytes = 1;
+    size_t count = 1;
+    while (count * 2 * sizeof(TtBucket) <= megabytes * 1024 * 1024) count *= 2;
+    size_t bytes = count * sizeof(TtBucket);
+    if (tt->buckets && bytes == tt->bytes) {
+        tt_clear(tt);
+        return true;
+    }
+    bool huge;
+    void* p = alloc_pages_internal(bytes, &huge);
+    if (!p) return false;
+    tt_free(tt);
+    // 新分配的页已经清零，全零的表项就是空表项
+    tt->buckets = (TtBucket*)p;
+    tt->bucketMask = count - 1;
+    tt->bytes = bytes;
+    tt->hugePages = huge;
+    tt->generation = 0;
+    return true;
+}
+
+void tt_free(TranspositionTable* tt) {
+    if (tt->buckets) free_pages_internal(tt->buckets, tt->bytes);
+    tt->buckets = NULL;
+    tt->bucketMask = 0;
+    tt->bytes = 0;
+    tt->hugePages = false;
+}
+
+void tt_clear(TranspositionTable* tt) {
+    for (uint64_t i = 0; i <= tt->bucketMask && tt->buckets; i++) {
+        for (int k = 0; k < TT_BUCKET_ENTRIES; k++) {
+            tt->buckets[i].entries[k].data.store(0, std::memory_order_relaxed);
+            tt->buckets[i].entries[k].check.store(0, std::memory_order_relaxed);
+        }
+    }
+    tt->generation = 0;
+    tt->probes = 0;
+    tt->hits = 0;
+    tt->stores = 0;
+    tt->collisions = 0;
+}
+
+int tt_fill_permille(const TranspositionTable* tt) {
+    if (!tt->buckets) return 0;
+    uint64_t n = tt->bucketMask + 1 < 1000 ? tt->bucketMask + 1 : 1000;
+    unsigned gen = tt->generation & TT_GENERATION_MASK;
+    uint64_t used = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        for (int k = 0; k < TT_BUCKET_ENTRIES; k++) {
+            uint64_t d = tt->buckets[i].entries[k].data.load(std::memory_order_relaxed);
+            if (tt_data_bound(d) != TT_BOUND_NONE && tt_data_generation(d) == gen) used++;
+        }
+    }
+    return (int)(used * 1000 / (n * TT_BUCKET_ENTRIES));
+}
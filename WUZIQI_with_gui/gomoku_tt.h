@@ -0,0 +1,131 @@
+#pragma once
+#ifndef GOMOKU_TT_H
+#define GOMOKU_TT_H
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// 置换表（搜索内部使用）。整张表一次分配，能用大页时用大页（见 gomoku_tt.cpp）。
+// 每个桶 64 字节，恰好一条缓存行，放 4 个表项；按键的低位选桶，桶内按完整的 64 位键核对。
+// 表项只有两个 64 位字：data 保存分数/深度/边界/着法/世代，check = key ^ data。
+// 读写都不加锁：另一个线程写到一半时读到的两个字对不上，check ^ data 不等于 key，按未命中处理。
+// 替换策略以深度优先：同一局面的表项按深度覆盖，桶满时淘汰（深度 - 8 * 世代差）最小的表项。
+
+#define TT_BUCKET_ENTRIES 4
+#define TT_NO_MOVE 511
+#define TT_GENERATION_MASK 63
+
+enum TtBound {
+    TT_BOUND_NONE = 0,
+    TT_BOUND_UPPER,  // 分数 <= alpha，真实值不超过该分数
+    TT_BOUND_LOWER,  // 分数 >= beta，真实值不低于该分数
+    TT_BOUND_EXACT
+};
+
+struct TtEntry {
+    std::atomic<uint64_t> check;
+    std::atomic<uint64_t> data;
+};
+
+struct alignas(64) TtBucket {
+    TtEntry entries[TT_BUCKET_ENTRIES];
+};
+
+struct TtData {
+    int score;
+    int depth;
+    int bound;
+    int move;  // r * GOMOKU_MAX_SIZE + c，没有着法时为 TT_NO_MOVE
+};
+
+struct TranspositionTable {
+    TtBucket* buckets;
+    uint64_t bucketMask;
+    size_t bytes;
+    bool hugePages;
+    std::atomic<unsigned> generation;  // 每次搜索开始时加一，用于淘汰旧表项
+    // 累计统计：搜索线程在本地计数，每次搜索结束时加到这里
+    std::atomic<uint64_t> probes;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> stores;
+    std::atomic<uint64_t> collisions;
+};
+
+// data 的位布局：0-23 分数（加 2^23 偏移）、24-31 深度、32-33 边界、34-42 着法、43-48 世代
+#define TT_SCORE_OFFSET (1 << 23)
+
+static inline uint64_t tt_pack(int score, int depth, int bound, int move, unsigned generation) {
+    if (depth < 0) depth = 0;
+    if (depth > 255) depth = 255;
+    return (uint64_t)(uint32_t)(score + TT_SCORE_OFFSET)
+        | ((uint64_t)depth << 24)
+        | ((uint64_t)bound << 32)
+        | ((uint64_t)move << 34)
+        | ((uint64_t)(generation & TT_GENERATION_MASK) << 43);
+}
+
+static inline int tt_data_depth(uint64_t d) { return (int)((d >> 24) & 0xFF); }
+static inline int tt_data_bound(uint64_t d) { return (int)((d >> 32) & 3); }
+static inline int tt_data_move(uint64_t d) { return (int)((d >> 34) & 0x1FF); }
+static inline unsigned tt_data_generation(uint64_t d) { return (unsigned)((d >> 43) & TT_GENERATION_MASK); }
+
+static inline bool tt_probe(const TranspositionTable* tt, uint64_t key, TtData* out) {
+    const TtBucket& b = tt->buckets[key & tt->bucketMask];
+    for (int i = 0; i < TT_BUCKET_ENTRIES; i++) {
+        uint64_t d = b.entries[i].data.load(std::memory_order_relaxed);
+        uint64_t c = b.entries[i].check.load(std::memory_order_relaxed);
+        if ((c ^ d) != key || tt_data_bound(d) == TT_BOUND_NONE) continue;
+        out->score = (int)(d & 0xFFFFFF) - TT_SCORE_OFFSET;
+        out->depth = tt_data_depth(d);
+        out->bound = tt_data_bound(d);
+        out->move = tt_data_move(d);
+        return true;
+    }
+    return false;
+}
+
+// 写入一个表项；返回 true 表示挤掉了本轮搜索中另一个局面的有效表项（索引冲突）
+static inline bool tt_store(TranspositionTable* tt, uint64_t key, int depth, int bound, int score, int move) {
+    TtBucket& b = tt->buckets[key & tt->bucketMask];
+    unsigned gen = tt->generation & TT_GENERATION_MASK;
+    int victim = 0, victimValue = 1 << 30;
+    for (int i = 0; i < TT_BUCKET_ENTRIES; i++) {
+        uint64_t d = b.entries[i].data.load(std::memory_order_relaxed);
+        uint64_t c = b.entries[i].check.load(std::memory_order_relaxed);
+        if (tt_data_bound(d) == TT_BOUND_NONE) {
+            victim = i;
+            victimValue = -(1 << 30);
+            continue;
+        }
+        if ((c ^ d) == key) {
+            // 同一局面：浅得多的非精确结果不覆盖本轮更深的结果；新结果没有着法时保留原来的着法
+            if (bound != TT_BOUND_EXACT && depth + 2 < tt_data_depth(d) && tt_data_generation(d) == gen) return false;
+            if (move == TT_NO_MOVE) move = tt_data_move(d);
+            victim = i;
+            victimValue = -(1 << 30) - 1;
+            break;
+        }
+        int age = (int)((gen - tt_data_generation(d)) & TT_GENERATION_MASK);
+        int value = tt_data_depth(d) - 8 * age;
+        if (value < victimValue) {
+            victim = i;
+            victimValue = value;
+        }
+    }
+    TtEntry& e = b.entries[victim];
+    bool collision = victimValue > -(1 << 30)
+        && tt_data_generation(e.data.load(std::memory_order_relaxed)) == gen;
+    uint64_t data = tt_pack(score, depth, bound, move, gen);
+    e.data.store(data, std::memory_order_relaxed);
+    e.check.store(key ^ data, std::memory_order_relaxed);
+    return collision;
+}
+
+// 按 megabytes 分配（向下取 2 的幂个桶），成功后清空旧表；失败时原表保持不变
+bool tt_resize(TranspositionTable* tt, size_t megabytes);
+void tt_free(TranspositionTable* tt);
+void tt_clear(TranspositionTable* tt);
+// 取前 1000 个桶估算本轮世代的表项占用，返回千分比
+int tt_fill_permille(const TranspositionTable* tt);
+
+#endif // GOMOKU_TT_H
@@ -0,0 +1,121 @@
+#define _CRT_SECURE_NO_WARNINGS  //  MSVC ڰȫľ
+// ֿ⽨⹤ߣͳƴ浵ļgomoku_save() ıʽ gomoku_save_binary() ĶƸʽ
+// ׿е֣д gomoku_book_open() ӳĿֿ⡣ GUI  WUZIQI_with_gui µ߼Դļ
+//
+//   book_builder [ѡ] ļ 浵ļ...
+//     -size N     ̳ߴ磨15/19/20Ĭ 15
+//     -rule R     freestyle / exact / caro / renjuĬ freestyle
+//     -plies N    ÿ¼Ĭ GOMOKU_BOOK_DEFAULT_PLIES
+//     -min N      ֻ¼پ N ֵľ棨Ĭ GOMOKU_BOOK_DEFAULT_MIN_GAMES
+//     -db PATH    ¼׿ PATH еȫѷʤ
+//     -list FILE  ¼ FILE гĴ浵ļ
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "WUZIQI_with_gui/gomoku_logic.h"
+#include "WUZIQI_with_gui/gomoku_book.h"
+#include "WUZIQI_with_gui/gomoku_db.h"
+
+static void usage() {
+    printf("÷book_builder [-size N] [-rule freestyle|exact|caro|renju] [-plies N] [-min N] [-db PATH] [-list FILE] ļ 浵ļ...\n");
+}
+
+static bool parseRule(const char* s, GomokuRule* rule) {
+    static const char* names[] = { "freestyle", "exact", "caro", "renju" };
+    for (int i = 0; i < 4; i++) {
+        if (!strcmp(s, names[i])) {
+            *rule = (GomokuRule)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void addFile(GomokuBookBuilder* b, const char* name, int* added, int* skipped) {
+    if (gomoku_book_builder_add_file(b, name)) (*added)++;
+    else (*skipped)++;
+}
+
+static void addList(GomokuBookBuilder* b, const char* listName, int* added, int* skipped) {
+    FILE* fp = fopen(listName, "r");
+    if (!fp) {
+        printf("޷бļ %s\n", listName);
+        return;
+    }
+    char line[1024];
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0]) addFile(b, line, added, skipped);
+    }
+    fclose(fp);
+}
+
+static void addDb(GomokuBookBuilder* b, const char* path, int size, GomokuRule rule, int* added, int* skipped) {
+    GomokuDb* db = gomoku_db_open(path, false);
+    if (!db) {
+        printf("޷׿ %s\n", path);
+        return;
+    }
+    GomokuGame* g = gomoku_game_create_variant(size, rule);
+    uint64_t count = gomoku_db_game_count(db);
+    for (uint64_t id = 0; g && id < count; id++) {
+        GomokuDbResult result;
+        if (gomoku_db_load_game(db, id, g, &result) && gomoku_book_builder_add_game(b, g, result)) (*added)++;
+        else (*skipped)++;
+    }
+    gomoku_game_destroy(g);
+    gomoku_db_close(db);
+}
+
+int main(int argc, char* argv[]) {
+    int size = GOMOKU_SIZE, plies = GOMOKU_BOOK_DEFAULT_PLIES;
+    unsigned minGames = GOMOKU_BOOK_DEFAULT_MIN_GAMES;
+    GomokuRule rule = GOMOKU_RULE_FREESTYLE;
+    const char* dbPath = NULL;
+    const char* listName = NULL;
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i += 2) {
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        const char* opt = argv[i];
+        const char* val = argv[i + 1];
+        if (!strcmp(opt, "-size")) size = atoi(val);
+        else if (!strcmp(opt, "-plies")) plies = atoi(val);
+        else if (!strcmp(opt, "-min")) minGames = (unsigned)atoi(val);
+        else if (!strcmp(opt, "-db")) dbPath = val;
+        else if (!strcmp(opt, "-list")) listName = val;
+        else if (strcmp(opt, "-rule") || !parseRule(val, &rule)) {
+            usage();
+            return 1;
+        }
+    }
+    if (i >= argc) {
+        usage();
+        return 1;
+    }
+    const char* output = argv[i++];
+    GomokuBookBuilder* b = gomoku_book_builder_create(size, rule, plies);
+    if (!b) {
+        printf("ֵ֧Ĳ%d ·¼ %d \n", size, plies);
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    int added = 0, skipped = 0;
+    for (; i < argc; i++) addFile(b, argv[i], &added, &skipped);
+    if (listName) addList(b, listName, &added, &skipped);
+    if (dbPath) addDb(b, dbPath, size, rule, &added, &skipped);
+    int64_t written = gomoku_book_builder_write(b, output, minGames);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("¼ %d ֣ %d ֣δʤߴ򲻷ȡʧܣ %llu \n",
+        added, skipped, (unsigned long long)gomoku_book_builder_positions(b));
+    gomoku_book_builder_destroy(b);
+    if (written < 0) {
+        printf("д %s ʧ\n", output);
+        return 1;
+    }
+    printf("д %s%lld 棨 %u ֣ʱ %.0f ms\n", output, (long long)written, minGames, ms);
+    return 0;
+}
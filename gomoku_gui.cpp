@@ -5,19 +5,21 @@
  * ߼ӿڣʾ gomoku_logic.h  gomoku_logic.c ʵ֣
  *   void gomoku_init();                                // ʼ̺״̬
  *   bool gomoku_make_move(int row, int col);           //  (row,col) ӣسɹ
- *   bool gomoku_undo_moves();                          // Ƿɹ
+ *   bool gomoku_undo_moves();                          // ָ߷Ƿɹ
+ *   bool gomoku_redo(int plies);                       //  plies Ƿɹ
  *   bool gomoku_save(const char *filename);            // ֵļ
  *   bool gomoku_load(const char *filename);            // ļ
  *   bool gomoku_check_win(int row, int col);           // Ƿʤ
  *   void gomoku_switch_player();                       // лǰ
  *   char gomoku_current_player();                      // ȡǰ 'X'  'O'
  *   void gomoku_detect_threats();                      // ڲάв
- *   const int (*gomoku_get_threat_marks())[SIZE];      // ȡвָ
+ *   const int (*gomoku_get_threat_marks())[GOMOKU_MAX_SIZE]; // ȡвָ
  *   void gomoku_mark_win(int row, int col);            // ڲʤ
- *   const int (*gomoku_get_win_marks())[SIZE];         // ȡʤָ
+ *   const int (*gomoku_get_win_marks())[GOMOKU_MAX_SIZE];    // ȡʤָ
  *   int gomoku_move_count();                           // ǰ
  *   void gomoku_get_move(int index, int *row, int *col);// ȡ index λ
  *   int gomoku_board_cell(int row, int col);           // ȡĳ״̬ 'X','O'  ' '
+ *   int gomoku_board_size();                           // ·15/19/20ӴСɴ˼
  *   // ѡ߼ӿ
  *   void gomoku_touch_opponent();                      // ߼ڲͷ־
  *   bool gomoku_was_touched();                         // ߼ѯǷҪʾͷʾ
@@ -28,7 +30,8 @@
  *   - ʼ SDL2/TTF
  *   - ̡ӡͨ߼ӿڻȡǣ
  *   - ¼ gomoku_make_moveٵ gomoku_check_wingomoku_switch_player
- *   - ̿ݼ U:  gomoku_undo_moves + gomoku_switch_player
+ *   - ̿ݼ U:  gomoku_undo_moves߼ָ߷лң
+ *                  Y:  gomoku_redo(2)
  *                  S: gomoku_save
  *                  L: gomoku_load
  *                  R: 븴ģʽGUI ͨ gomoku_init+gomoku_make_move 
@@ -48,11 +51,14 @@
 #include <string.h>
 #include "gomoku_logic.h"  // ӿڣҪʵ
 
-#define SIZE 15
 #define WINDOW_SIZE 600
 #define INFO_HEIGHT 80
 #define WINDOW_HEIGHT (WINDOW_SIZE + INFO_HEIGHT)
-#define CELL_SIZE (WINDOW_SIZE / SIZE)
+
+// ÿ·仯
+static int cellSize(void) {
+    return WINDOW_SIZE / gomoku_board_size();
+}
 
 SDL_Window* window = NULL;
 SDL_Renderer* renderer = NULL;
@@ -92,19 +98,21 @@ void drawBoardGUI(bool inReviewMode, int reviewStep) {
     // ߼Զвʤ
     gomoku_detect_threats();
     // 
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            int x = j * CELL_SIZE;
-            int y = i * CELL_SIZE;
-            SDL_Rect cellRect = { x, y, CELL_SIZE, CELL_SIZE };
+    int n = gomoku_board_size();
+    int cs = cellSize();
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            int x = j * cs;
+            int y = i * cs;
+            SDL_Rect cellRect = { x, y, cs, cs };
             // ʤߣɫ
-            const int (*winMarks)[SIZE] = gomoku_get_win_marks();
+            const int (*winMarks)[GOMOKU_MAX_SIZE] = gomoku_get_win_marks();
             if (winMarks[i][j]) {
                 SDL_SetRenderDrawColor(renderer, 144, 238, 144, 255);
                 SDL_RenderFillRect(renderer, &cellRect);
             }
             // в㣺ɫףԾʱʾ
-            const int (*threatMarks)[SIZE] = gomoku_get_threat_marks();
+            const int (*threatMarks)[GOMOKU_MAX_SIZE] = gomoku_get_threat_marks();
             if (!inReviewMode && threatMarks[i][j]) {
                 SDL_SetRenderDrawColor(renderer, 173, 216, 230, 255);
                 SDL_RenderFillRect(renderer, &cellRect);
@@ -115,7 +123,7 @@ void drawBoardGUI(bool inReviewMode, int reviewStep) {
             // 
             char ch = gomoku_board_cell(i, j);
             if (ch == 'X' || ch == 'O') {
-                SDL_Rect pieceRect = { x + 4, y + 4, CELL_SIZE - 8, CELL_SIZE - 8 };
+                SDL_Rect pieceRect = { x + 4, y + 4, cs - 8, cs - 8 };
                 if (ch == 'X') SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
                 else SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
                 SDL_RenderFillRect(renderer, &pieceRect);
@@ -129,7 +137,7 @@ void drawBoardGUI(bool inReviewMode, int reviewStep) {
     if (!inReviewMode && moveCount > 0) {
         int lr, lc;
         gomoku_get_move(moveCount - 1, &lr, &lc);
-        SDL_Rect lastRect = { lc * CELL_SIZE, lr * CELL_SIZE, CELL_SIZE, CELL_SIZE };
+        SDL_Rect lastRect = { lc * cs, lr * cs, cs, cs };
         SDL_SetRenderDrawColor(renderer, 255, 215, 0, 255);
         for (int k = 0; k < 3; k++) SDL_RenderDrawRect(renderer, &lastRect);
     }
@@ -168,7 +176,7 @@ void runGUI() {
     int reviewStep = 0;
     // ״̬˳
     // ʱⲿͨ gomoku_init + gomoku_make_move ֲ
-    char savedBoardState[SIZE][SIZE];
+    char savedBoardState[GOMOKU_MAX_SIZE][GOMOKU_MAX_SIZE];
     int savedMoveCount;
     char savedPlayer;
 
@@ -215,8 +223,8 @@ void runGUI() {
                 if (e.type == SDL_MOUSEBUTTONDOWN) {
                     int x = e.button.x, y = e.button.y;
                     if (y < WINDOW_SIZE) {
-                        int c = x / CELL_SIZE;
-                        int r = y / CELL_SIZE;
+                        int c = x / cellSize();
+                        int r = y / cellSize();
                         if (gomoku_make_move(r, c)) {
                             if (gomoku_check_win(r, c)) {
                                 showMessage((gomoku_current_player() == 'X' ? " X ʤ!" : " O ʤ!"), 5);
@@ -230,9 +238,10 @@ void runGUI() {
                 else if (e.type == SDL_KEYDOWN) {
                     switch (e.key.keysym.sym) {
                     case SDLK_u:
-                        if (gomoku_undo_moves()) {
-                            gomoku_switch_player();
-                        }
+                        gomoku_undo_moves();
+                        break;
+                    case SDLK_y:
+                        gomoku_redo(2);
                         break;
                     case SDLK_s:
                         if (gomoku_save(SAVE_FILE)) showMessage("ѱ", 2);
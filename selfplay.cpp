@@ -0,0 +1,240 @@
+#define _CRT_SECURE_NO_WARNINGS  //  MSVC ڰȫľ
+// Զѵɹߣ̲߳»ɵĶԾ֣ÿ̶
+// Ѿ桢߷սдɶ WUZIQI_with_gui/gomoku_samples.hķƬļ
+//  GUI  WUZIQI_with_gui µ߼Դļ
+//
+// ֻӾ i ֵ (, i) ÿ߳˽ûÿǰա̰߳ڵԤ
+// Ƭ k ̶յ k * ÿƬ Щֵ֣ı˳д롣߳ͬɵļҲֽͬ
+//
+//   selfplay [ѡ]
+//     -games N     ԾĬ 1000
+//     -threads N   е߳0 Ϊȫ߼ģĬ 0
+//     -depth N     ÿȣĬ SELFPLAY_DEPTH
+//     -nodes N     ÿĽڵԤ㣬0 ΪޣĬ SELFPLAY_NODESԤҲƸڵв
+//     -random N    ǰ N ĸӣĬ SELFPLAY_RANDOM_PLIES
+//     -seed N      ӣĬ 1
+//     -shard N     ÿƬľĬ SELFPLAY_SHARD_GAMES
+//     -out PREFIX  Ƭļǰ׺ļΪ PREFIX-NNNN.gmsĬ selfplay
+//     -size N      ̳ߴ磨15/19/20Ĭ 15
+//     -rule R      freestyle / exact / caro / renjuĬ freestyle
+//     -nnue FILE   
+//     -dedupe 1    ͬһƬھתתͬľֻǵһγֵһһɻɹ淶򣨼 gomoku_canonical_hash()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "WUZIQI_with_gui/gomoku_logic.h"
+#include "WUZIQI_with_gui/gomoku_ai.h"
+#include "WUZIQI_with_gui/gomoku_samples.h"
+
+#define SELFPLAY_DEPTH 4
+#define SELFPLAY_NODES 20000
+#define SELFPLAY_RANDOM_PLIES 4
+#define SELFPLAY_SHARD_GAMES 1000
+#define SELFPLAY_HASH_MB 16  // ÿ̵߳˽û
+#define MAX_PLIES (GOMOKU_MAX_SIZE * GOMOKU_MAX_SIZE)
+
+struct Options {
+    uint64_t games;
+    int threads;
+    int depth;
+    uint64_t nodes;
+    int randomPlies;
+    uint64_t seed;
+    uint64_t shardGames;
+    const char* out;
+    int size;
+    GomokuRule rule;
+    bool nnue;
+    bool dedupe;
+};
+
+// ̺߳ϼƵͳ
+struct Totals {
+    std::atomic<uint64_t> games;
+    std::atomic<uint64_t> positions;
+    std::atomic<uint64_t> duplicates;
+    std::atomic<uint64_t> nodes;
+    std::atomic<uint64_t> xWins, oWins, draws;
+    std::atomic<uint64_t> nextShard;
+    std::atomic<bool> failed;
+};
+
+static uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static bool parseRule(const char* s, GomokuRule* rule) {
+    static const char* names[] = { "freestyle", "exact", "caro", "renju" };
+    for (int i = 0; i < 4; i++) {
+        if (!strcmp(s, names[i])) {
+            *rule = (GomokuRule)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+//  index ֣׷ӵ samplesseen Ϊ NULL ʱеĹ淶沢ɹ淶
+// ս1 Ϊ 'X' ʤ2 Ϊ 'O' ʤ0 Ϊ壩
+static int playGame(const Options* o, uint64_t index, GomokuGame* g, std::vector<GomokuSample>* samples,
+    std::unordered_set<uint64_t>* seen, uint64_t* nodes, uint64_t* duplicates) {
+    uint64_t rng = o->seed ^ (index * 0xD1B54A32D192ED03ull);
+    gomoku_game_init_variant(g, o->size, o->rule);
+    if (o->nnue) gomoku_game_set_nnue(g, true);
+    gomoku_ai_clear_hash();
+    size_t first = samples->size();
+    int winner = 0;
+    for (int ply = 0; ply < o->size * o->size; ply++) {
+        int r, c;
+        if (ply < o->randomPlies) {
+            // ֣ΧʱΪԪĺѡһ
+            int moves[MAX_PLIES][2];
+            int n = gomoku_game_candidate_moves(g, 1, moves, MAX_PLIES);
+            int k = n > 0 ? (int)(splitmix64(&rng) % (uint64_t)n) : 0, tries = 0;
+            while (tries < n && gomoku_game_is_forbidden(g, moves[k][0], moves[k][1])) {
+                k = (k + 1) % n;
+                tries++;
+            }
+            if (tries == n) break;
+            r = moves[k][0];
+            c = moves[k][1];
+        }
+        else {
+            GomokuSearchLimits limits = {};
+            limits.engine = GOMOKU_ENGINE_ALPHA_BETA;
+            limits.maxNodes = o->nodes;
+            limits.maxDepth = o->depth;
+            GomokuAiStats st;
+            if (!gomoku_game_search(g, &limits, &r, &c, &st)) break;
+            *nodes += st.nodes;
+            int symmetry = 0;
+            if (seen && !seen->insert(gomoku_game_canonical_hash(g, &symmetry)).second) {
+                (*duplicates)++;
+            }
+            else {
+                GomokuSample s;
+                gomoku_sample_pack(g, st.score, r, c, &s);
+                if (symmetry) gomoku_sample_transform(&s, o->size, symmetry, &s);
+                samples->push_back(s);
+            }
+        }
+        if (!gomoku_game_make_move(g, r, c)) break;
+        if (gomoku_game_check_win(g, r, c)) {
+            winner = gomoku_game_current_player(g) == 'X' ? 1 : 2;
+            break;
+        }
+        gomoku_game_switch_player(g);
+    }
+    for (size_t i = first; i < samples->size(); i++) {
+        GomokuSample& s = (*samples)[i];
+        s.result = (int8_t)(winner == 0 ? 0 : (winner - 1 == s.sideToMove ? 1 : -1));
+    }
+    return winner;
+}
+
+static void worker(const Options* o, Totals* t) {
+    gomoku_ai_set_thread_hash_size(SELFPLAY_HASH_MB);
+    GomokuGame* g = gomoku_game_create_variant(o->size, o->rule);
+    std::vector<GomokuSample> samples;
+    std::unordered_set<uint64_t> seen;
+    uint64_t shards = (o->games + o->shardGames - 1) / o->shardGames;
+    for (uint64_t k; g && (k = t->nextShard.fetch_add(1)) < shards && !t->failed; ) {
+        char name[512];
+        snprintf(name, sizeof(name), "%s-%04llu.gms", o->out, (unsigned long long)k);
+        GomokuSampleWriter* w = gomoku_sample_writer_open(name, o->size, o->rule, (uint32_t)k, o->seed);
+        if (!w) {
+            printf("޷д %s\n", name);
+            t->failed = true;
+            break;
+        }
+        seen.clear();
+        uint64_t end = (k + 1) * o->shardGames < o->games ? (k + 1) * o->shardGames : o->games;
+        for (uint64_t i = k * o->shardGames; i < end && !t->failed; i++) {
+            samples.clear();
+            uint64_t nodes = 0, duplicates = 0;
+            int winner = playGame(o, i, g, &samples, o->dedupe ? &seen : NULL, &nodes, &duplicates);
+            if (!gomoku_sample_writer_add(w, samples.data(), (int)samples.size())) t->failed = true;
+            t->games++;
+            t->positions += samples.size();
+            t->nodes += nodes;
+            t->duplicates += duplicates;
+            (winner == 1 ? t->xWins : (winner == 2 ? t->oWins : t->draws))++;
+        }
+        if (!gomoku_sample_writer_close(w)) {
+            printf("д %s ʧ\n", name);
+            t->failed = true;
+        }
+    }
+    gomoku_game_destroy(g);
+    gomoku_ai_set_thread_hash_size(0);
+}
+
+int main(int argc, char* argv[]) {
+    Options o = { 1000, 0, SELFPLAY_DEPTH, SELFPLAY_NODES, SELFPLAY_RANDOM_PLIES, 1, SELFPLAY_SHARD_GAMES, "selfplay",
+        GOMOKU_SIZE, GOMOKU_RULE_FREESTYLE, false, false };
+    for (int i = 1; i < argc; i += 2) {
+        const char* opt = argv[i];
+        const char* val = i + 1 < argc ? argv[i + 1] : NULL;
+        bool ok = true;
+        if (!val) ok = false;
+        else if (!strcmp(opt, "-games")) o.games = strtoull(val, NULL, 10);
+        else if (!strcmp(opt, "-threads")) o.threads = atoi(val);
+        else if (!strcmp(opt, "-depth")) o.depth = atoi(val);
+        else if (!strcmp(opt, "-nodes")) o.nodes = strtoull(val, NULL, 10);
+        else if (!strcmp(opt, "-random")) o.randomPlies = atoi(val);
+        else if (!strcmp(opt, "-seed")) o.seed = strtoull(val, NULL, 10);
+        else if (!strcmp(opt, "-shard")) o.shardGames = strtoull(val, NULL, 10);
+        else if (!strcmp(opt, "-out")) o.out = val;
+        else if (!strcmp(opt, "-size")) o.size = atoi(val);
+        else if (!strcmp(opt, "-rule")) ok = parseRule(val, &o.rule);
+        else if (!strcmp(opt, "-nnue")) ok = o.nnue = gomoku_nnue_load(val);
+        else if (!strcmp(opt, "-dedupe")) o.dedupe = atoi(val) != 0;
+        else ok = false;
+        if (!ok || o.depth < 1 || o.shardGames == 0) {
+            printf("÷selfplay [-games N] [-threads N] [-depth N] [-nodes N] [-random N] [-seed N] [-shard N] [-out PREFIX]"
+                " [-size N] [-rule freestyle|exact|caro|renju] [-nnue FILE] [-dedupe 0|1]\n");
+            return 1;
+        }
+    }
+    GomokuGame* probe = gomoku_game_create_variant(o.size, o.rule);
+    if (!probe) {
+        printf("ֵ֧̳ߴ %d\n", o.size);
+        return 1;
+    }
+    if (o.nnue && !gomoku_game_set_nnue(probe, true)) {
+        printf("粻 %d ·\n", o.size);
+        return 1;
+    }
+    gomoku_game_destroy(probe);
+    // ÿֵֻ߳ڶԾ֮
+    gomoku_ai_set_threads(1);
+    unsigned cores = std::thread::hardware_concurrency();
+    int threads = o.threads > 0 ? o.threads : (cores ? (int)cores : 1);
+    Totals t;
+    t.games = t.positions = t.duplicates = t.nodes = t.xWins = t.oWins = t.draws = t.nextShard = 0;
+    t.failed = false;
+    printf("Զ %llu ֣%d · %dÿ %llu ڵ㣬%d ̣߳ %llu\n", (unsigned long long)o.games, o.size,
+        o.depth, (unsigned long long)o.nodes, threads, (unsigned long long)o.seed);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; i++) pool.emplace_back(worker, &o, &t);
+    for (size_t i = 0; i < pool.size(); i++) pool[i].join();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (sec <= 0) sec = 1e-9;
+    uint64_t positions = t.positions;
+    printf(" %llu ֣'X' ʤ %llu'O' ʤ %llu %llu%llu 棬ʱ %.1f \n",
+        (unsigned long long)t.games.load(), (unsigned long long)t.xWins.load(), (unsigned long long)t.oWins.load(),
+        (unsigned long long)t.draws.load(), (unsigned long long)positions, sec);
+    if (o.dedupe) printf("ȥƬڶԳظľ %llu \n", (unsigned long long)t.duplicates.load());
+    printf("ٶȣ%.0f /룬%.0f //ˣ%.0f ڵ/\n", positions / sec, positions / sec / threads,
+        t.nodes / sec);
+    return t.failed ? 1 : 0;
+}
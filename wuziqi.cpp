@@ -3,9 +3,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include <conio.h>  // ڷ _getch()
+#include <chrono>
+#include <thread>
+#include "WUZIQI_with_gui/gomoku_logic.h"  // ̳ߴ߼㱣һ
+#include "WUZIQI_with_gui/gomoku_ai.h"     // AI սʹ߼
 
-#define SIZE 15
+#define SIZE GOMOKU_SIZE
 #define MAX_MOVES (SIZE * SIZE)
+#define AI_THINK_MS 1000  // AI ÿֵĬ˼ʱ䣬 time ָ޸
+#define BENCH_DEPTH 10     // ̲߳ٵ
+#define PROOF_NODES 5000000  // ֤ĽԤ
+#define PROOF_TABLE_MB 64
 
 char board[SIZE][SIZE];
 char currentPlayer;
@@ -17,6 +25,8 @@ int cursorRow, cursorCol;
 int winMarks[SIZE][SIZE];
 int threatMarks[SIZE][SIZE];
 int inKeyboardMode = 0; 
+char aiPlayer = '\0';  // AI ִӣ'\0' ʾ˫˶ս
+int aiThinkMs = AI_THINK_MS;  // AI ÿֵʱԤ㣨룩ᳬ
 
 void initBoard() {
     for (int i = 0; i < SIZE; i++)
@@ -207,6 +217,90 @@ void loadGame(const char* filename) {
     printf("Ѵ %s أļ...\n", filename);
 }
 
+// ȣÿʱӡȡٶ߳еã
+void printAiProgress(const GomokuSearchProgress* p, void* userData) {
+    static int lastDepth = 0;
+    (void)userData;
+    if (p->done || p->depth == 0) {
+        lastDepth = 0;
+        return;
+    }
+    if (p->depth == lastDepth) return;
+    lastDepth = p->depth;
+    printf("   %2d   %8d  %6d ms  %8llu ڵ/  ", p->depth, p->score, p->timeMs,
+        (unsigned long long)p->nodesPerSecond);
+    for (int i = 0; i < p->pvLength && i < 8; i++) printf(" (%d,%d)", p->pv[i][0], p->pv[i][1]);
+    printf("\n");
+}
+
+// AI ѡ㣺ѵǰְ˳طŵ߼־ϣں̨ϸ aiThinkMs ʱ
+int aiChooseMove(int* r, int* c) {
+    GomokuGame* g = gomoku_game_create();
+    if (!g) return 0;
+    for (int i = 0; i < moveCount; i++) {
+        gomoku_game_make_move(g, moveHistory[i][0], moveHistory[i][1]);
+        gomoku_game_switch_player(g);
+    }
+    GomokuSearchLimits limits = {};
+    limits.engine = GOMOKU_ENGINE_ALPHA_BETA;
+    limits.timeMs = aiThinkMs;
+    GomokuSearch* search = gomoku_search_start(g, &limits, printAiProgress, NULL);
+    gomoku_game_destroy(g);
+    if (!search) return 0;
+    // ˼ڼ䰴 AI ߵĿǰΪֹŷ
+    while (!gomoku_search_done(search)) {
+        if (_kbhit()) {
+            _getch();
+            gomoku_search_stop(search);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    GomokuAiStats stats;
+    int ok = gomoku_search_wait(search, r, c, &stats);
+    gomoku_search_destroy(search);
+    if (ok) printf("AI  (%d,%d) %d%llu ڵ㣬ʱ %d ms\n", *r, *c, stats.depth, (unsigned long long)stats.nodes, stats.timeMs);
+    return ok;
+}
+
+// ֤ǰ棺طŵ߼־֤ʤ/ذ/δ֪֤С
+void proveGame() {
+    GomokuGame* g = gomoku_game_create();
+    if (!g) return;
+    for (int i = 0; i < moveCount; i++) {
+        gomoku_game_make_move(g, moveHistory[i][0], moveHistory[i][1]);
+        gomoku_game_switch_player(g);
+    }
+    printf("֤ %d 㣩...\n", PROOF_NODES);
+    GomokuProofStats stats;
+    GomokuProofResult result = gomoku_game_prove(g, PROOF_NODES, PROOF_TABLE_MB, &stats);
+    if (result == GOMOKU_PROOF_WIN) printf(" %c ʤһ (%d,%d)", currentPlayer, stats.row, stats.col);
+    else if (result == GOMOKU_PROOF_LOSS) printf(" %c ذܡ", currentPlayer);
+    else printf("δ֤ʤ");
+    printf("֤ %llu 㣬 %llu 㣬ʱ %d ms\n", (unsigned long long)stats.proofSize,
+        (unsigned long long)stats.nodes, stats.timeMs);
+    gomoku_game_destroy(g);
+}
+
+// ̲߳٣һ̶Ŀ־ϣ 124߳ѵͬһȣȽʱ
+void benchmarkAi() {
+    static const int opening[][2] = { {7,7}, {6,6}, {5,7}, {5,6}, {6,8}, {4,7}, {4,6}, {7,9} };
+    GomokuGame* g = gomoku_game_create();
+    if (!g) return;
+    for (int i = 0; i < (int)(sizeof(opening) / sizeof(opening[0])); i++) {
+        gomoku_game_make_move(g, opening[i][0], opening[i][1]);
+        gomoku_game_switch_player(g);
+    }
+    int maxThreads = gomoku_ai_set_threads(0);
+    printf("̲߳٣ %d %d ߳\n", BENCH_DEPTH, maxThreads);
+    GomokuThreadBench results[16];
+    int n = gomoku_game_ai_benchmark(g, BENCH_DEPTH, maxThreads, results, 16);
+    for (int i = 0; i < n; i++) {
+        printf("  %3d ̣߳%6d ms%10llu ڵ㣬ٱ %.2f\n", results[i].threads, results[i].timeMs,
+            (unsigned long long)results[i].nodes, results[i].speedup);
+    }
+    gomoku_game_destroy(g);
+}
+
 void touchOpponent() {
     touchedFlag = 1; touchedPlayer = (currentPlayer == 'X') ? 'O' : 'X';
     printf(" %c ͷ\n", touchedPlayer);
@@ -218,6 +312,8 @@ void printHelp() {
     printf("  save       - \n");
     printf("  load       - ȡ\n");
     printf("  touch      - ͷ\n");
+    printf("  prove      - ֤ǰʤ\n");
+    printf("  time ms    -  AI ÿֵ˼ʱ䣨룩AI ˼ʱ\n");
     printf("  m          - ģʽ\n");
     printf("  exit       - ˳ǰԾֻ\n");
     printf("  help       - ʾ˵\n");
@@ -267,6 +363,10 @@ void keyboardModeInput() {
                     return;
                 }
                 switchPlayer();
+                if (currentPlayer == aiPlayer) {
+                    inKeyboardMode = 0;
+                    return;
+                }
             }
         }
         else if (ch == 27) {
@@ -279,9 +379,21 @@ void keyboardModeInput() {
 void runGame() {
     char input[32]; int gameOver = 0;
     while (!gameOver) {
+        if (currentPlayer == aiPlayer) {
+            int r, c;
+            if (!aiChooseMove(&r, &c)) { printf("AI ޴£塣\n"); gameOver = 1; break; }
+            if (makeMove(r, c)) { if (checkWin(r, c)) { printBoard(); printf("AI ʤ\n"); gameOver = 1; } else switchPlayer(); }
+            continue;
+        }
         printBoard(); printf("ǰ %cָhelp鿴ָ: ", currentPlayer); scanf("%s", input);
         if (!strcmp(input, "undo")) undoMoves(); else if (!strcmp(input, "save")) saveGame("save.txt");
         else if (!strcmp(input, "load")) loadGame("save.txt"); else if (!strcmp(input, "touch")) touchOpponent();
+        else if (!strcmp(input, "prove")) proveGame();
+        else if (!strcmp(input, "time")) {
+            int ms;
+            if (scanf("%d", &ms) == 1 && ms > 0) { aiThinkMs = ms; printf("AI ÿ˼ %d ms\n", aiThinkMs); }
+            else printf("Чʱ䡣\n");
+        }
         else if (!strcmp(input, "help")) printHelp(); else if (!strcmp(input, "m")) keyboardModeInput();
         else if (!strcmp(input, "exit")) { printf("˳֡\n"); return; }
         else if (!strcmp(input, "review")) { printf("Ϸδ޷̡\n"); }
@@ -295,14 +407,16 @@ void runGame() {
 
 int main() {
     int choice; initBoard();
+    gomoku_ai_set_threads(0);  // AI ʹȫ߼
     while (1) {
-        printf("\n===== ˵ =====\n"); printf("1. Ҷս\n2. AI սڴ\n3. ضԾ\n4. ˳\n");
-        printf("ѡ(1-4)"); scanf("%d", &choice);
+        printf("\n===== ˵ =====\n"); printf("1. Ҷս\n2. AI սִ X У\n3. ضԾ\n4. AI ̲߳\n5. ˳\n");
+        printf("ѡ(1-5)"); scanf("%d", &choice);
         switch (choice) {
-        case 1: initBoard(); runGame(); break;
-        case 2: printf("AI սܾڴ\n"); break;
-        case 3: loadGame("save.txt"); runGame(); break;
-        case 4: exit(0);
+        case 1: initBoard(); aiPlayer = '\0'; runGame(); break;
+        case 2: initBoard(); aiPlayer = 'O'; runGame(); break;
+        case 3: loadGame("save.txt"); aiPlayer = '\0'; runGame(); break;
+        case 4: benchmarkAi(); break;
+        case 5: exit(0);
         default: printf("Чѡ\n");
         }
     }